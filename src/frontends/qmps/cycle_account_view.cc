@@ -0,0 +1,94 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "qmps/cycle_account_view.h"
+
+#include <QLabel>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "umps/machine.h"
+#include "qmps/application.h"
+#include "qmps/debug_session.h"
+
+CycleAccountView::CycleAccountView(QWidget* parent)
+	: QWidget(parent),
+	dbgSession(Appl()->getDebugSession())
+{
+	QVBoxLayout* layout = new QVBoxLayout(this);
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->addWidget(new QLabel("<b>Cycle Accounting</b>"));
+
+	accountView = new QTreeWidget;
+	accountView->setRootIsDecorated(false);
+	accountView->setAlternatingRowColors(true);
+	accountView->setHeaderLabels(QStringList() << "ASID" << "Kernel" << "User"
+	                             << "Total" << "%");
+	layout->addWidget(accountView);
+
+	connect(dbgSession, SIGNAL(MachineStarted()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineReset()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineHalted()), this, SLOT(onMachineHalted()));
+	connect(dbgSession, SIGNAL(DebugIterationCompleted()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineStopped()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineRan()), this, SLOT(refreshView()));
+}
+
+void CycleAccountView::onMachineHalted()
+{
+	accountView->clear();
+}
+
+void CycleAccountView::refreshView()
+{
+	Machine* machine = dbgSession->getMachine();
+	if (machine == NULL)
+		return;
+
+	std::vector<Machine::CycleAccount> accounts = machine->getCycleAccounts();
+	uint64_t idle = machine->getIdleCycles();
+	uint64_t handlers = machine->getHandlerCycles();
+
+	uint64_t total = idle;
+	for (const Machine::CycleAccount& a : accounts)
+		total += a.kernel + a.user;
+	double scale = total > 0 ? 100.0 / total : 0.0;
+
+	accountView->clear();
+	for (const Machine::CycleAccount& a : accounts) {
+		QStringList columns;
+		columns << QString::number(a.asid, 16)
+		        << QString::number(a.kernel) << QString::number(a.user)
+		        << QString::number(a.kernel + a.user)
+		        << QString::number((a.kernel + a.user) * scale, 'f', 2);
+		accountView->addTopLevelItem(new QTreeWidgetItem(columns));
+	}
+
+	QStringList idleColumns;
+	idleColumns << "Idle" << "" << "" << QString::number(idle)
+	            << QString::number(idle * scale, 'f', 2);
+	accountView->addTopLevelItem(new QTreeWidgetItem(idleColumns));
+
+	QStringList handlerColumns;
+	handlerColumns << "Handlers" << "" << "" << QString::number(handlers)
+	               << QString::number(handlers * scale, 'f', 2);
+	accountView->addTopLevelItem(new QTreeWidgetItem(handlerColumns));
+}
@@ -0,0 +1,48 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef QMPS_CYCLE_ACCOUNT_VIEW_H
+#define QMPS_CYCLE_ACCOUNT_VIEW_H
+
+#include <QWidget>
+
+class QTreeWidget;
+class DebugSession;
+
+// A "top" of the simulated machine: cycles run by each ASID in kernel
+// and user mode, idle and exception handler cycles, over all cpus
+class CycleAccountView: public QWidget {
+	Q_OBJECT
+
+public:
+	CycleAccountView(QWidget* parent = 0);
+
+private Q_SLOTS:
+	void onMachineHalted();
+	void refreshView();
+
+private:
+	DebugSession* const dbgSession;
+
+	QTreeWidget* accountView;
+};
+
+#endif // QMPS_CYCLE_ACCOUNT_VIEW_H
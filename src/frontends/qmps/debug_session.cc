@@ -353,6 +353,7 @@ void DebugSession::stop()
 		stoppedByUser = true;
 		timer->stop();
 		idleTimer->stop();
+		machine->FlushOutput();
 		setStatus(MS_STOPPED);
 		Q_EMIT MachineStopped();
 	}
@@ -450,6 +451,15 @@ void DebugSession::skip()
 {
 	assert(idleSteps > 0);
 
+	// Device input may have arrived meanwhile, cutting the idle
+	// period short
+	idleSteps = std::min(idleSteps, machine->idleCycles());
+	if (idleSteps == 0) {
+		idleTimer->stop();
+		timer->start();
+		return;
+	}
+
 	const uint32_t skipped = std::min(idleSteps, kMaxSkipped);
 	machine->skip(skipped);
 	idleSteps -= skipped;
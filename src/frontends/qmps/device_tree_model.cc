@@ -30,7 +30,12 @@ const char* const DeviceTreeModel::headerNames[N_COLUMNS] = {
 	"Device",
 	"HW Failure",
 	"Status",
-	"Completion Time"
+	"Completion Time",
+	"Commands",
+	"Errors",
+	"DMA Bytes",
+	"Busy Cycles",
+	"Avg Queue Delay"
 };
 
 const char* const DeviceTreeModel::iconMap[N_EXT_IL] = {
@@ -193,6 +198,25 @@ QVariant DeviceTreeModel::data(const QModelIndex& index, int role) const
 
 		case COLUMN_COMPLETION_TOD:
 			return device->getCTimeInfo().c_str();
+
+		case COLUMN_COMMANDS:
+			return (qulonglong) device->getStats().commands;
+
+		case COLUMN_ERRORS:
+			return (qulonglong) device->getStats().errors;
+
+		case COLUMN_DMA_BYTES:
+			return (qulonglong) device->getStats().dmaBytes;
+
+		case COLUMN_BUSY_CYCLES:
+			return (qulonglong) device->getStats().busyCycles;
+
+		case COLUMN_QUEUE_DELAY: {
+			const DeviceStats& stats = device->getStats();
+			if (stats.queueWaits == 0)
+				return QVariant();
+			return QString::number((double) stats.queueCycles / stats.queueWaits, 'f', 1);
+		}
 		}
 	}
 
@@ -238,7 +262,7 @@ void DeviceTreeModel::onDeviceStatusChanged(const char* status, Device* device)
 	                               COLUMN_DEVICE_STATUS,
 	                               device);
 	QModelIndex idx2 = createIndex(device->getNumber(),
-	                               COLUMN_COMPLETION_TOD,
+	                               N_COLUMNS - 1,
 	                               device);
 	Q_EMIT dataChanged(idx1, idx2);
 }
@@ -41,6 +41,11 @@ enum {
 	COLUMN_DEVICE_CONDITION,
 	COLUMN_DEVICE_STATUS,
 	COLUMN_COMPLETION_TOD,
+	COLUMN_COMMANDS,
+	COLUMN_ERRORS,
+	COLUMN_DMA_BYTES,
+	COLUMN_BUSY_CYCLES,
+	COLUMN_QUEUE_DELAY,
 	N_COLUMNS
 };
 
@@ -0,0 +1,178 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "qmps/heatmap_view.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QComboBox>
+#include <QEvent>
+#include <QHelpEvent>
+#include <QLabel>
+#include <QPainter>
+#include <QToolTip>
+
+#include "umps/arch.h"
+#include "umps/const.h"
+#include "umps/machine.h"
+#include "umps/memory_heatmap.h"
+#include "qmps/application.h"
+#include "qmps/debug_session.h"
+#include "qmps/ui_utils.h"
+
+// The grid starts below the counter selector
+HIDDEN const int kGridTop = 32;
+
+HeatmapView::HeatmapView(QWidget* parent)
+	: QWidget(parent),
+	dbgSession(Appl()->getDebugSession()),
+	heatmap(NULL),
+	maxCount(0)
+{
+	QLabel* heading = new QLabel("<b>Memory Heatmap</b>", this);
+	heading->move(2, 6);
+
+	counterCombo = new QComboBox(this);
+	counterCombo->addItem("All Accesses");
+	counterCombo->addItem("Reads");
+	counterCombo->addItem("Writes");
+	counterCombo->addItem("Fetches");
+	counterCombo->addItem("DMA");
+	counterCombo->move(kColumns * kCellSize - counterCombo->sizeHint().width(), 2);
+	connect(counterCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(refreshView()));
+
+	placeholder = new QLabel("<i>Memory heatmap not enabled in the machine configuration</i>", this);
+	placeholder->move(2, kGridTop);
+
+	connect(dbgSession, SIGNAL(MachineStarted()), this, SLOT(onMachineStarted()));
+	connect(dbgSession, SIGNAL(MachineReset()), this, SLOT(onMachineStarted()));
+	connect(dbgSession, SIGNAL(MachineHalted()), this, SLOT(onMachineHalted()));
+	connect(dbgSession, SIGNAL(DebugIterationCompleted()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineStopped()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineRan()), this, SLOT(refreshView()));
+
+	setMouseTracking(true);
+}
+
+QSize HeatmapView::sizeHint() const
+{
+	int rows = (Appl()->getConfig()->getRamSize() + kColumns - 1) / kColumns;
+	return QSize(kColumns * kCellSize + 1, kGridTop + rows * kCellSize + 1);
+}
+
+void HeatmapView::onMachineStarted()
+{
+	heatmap = dbgSession->getMachine()->getHeatmap();
+	placeholder->setVisible(heatmap == NULL);
+	refreshView();
+}
+
+void HeatmapView::onMachineHalted()
+{
+	heatmap = NULL;
+	counts.clear();
+	update();
+}
+
+void HeatmapView::refreshView()
+{
+	if (heatmap == NULL)
+		return;
+
+	counts.resize(heatmap->getFrames());
+	maxCount = 0;
+	for (unsigned int frame = 0; frame < counts.size(); frame++) {
+		counts[frame] = count(frame, counterCombo->currentIndex());
+		maxCount = std::max(maxCount, counts[frame]);
+	}
+	update();
+}
+
+uint64_t HeatmapView::count(unsigned int frame, int counter) const
+{
+	switch (counter) {
+	case COUNTER_READS:
+		return heatmap->getTotal(frame, HEATMAP_READ);
+	case COUNTER_WRITES:
+		return heatmap->getTotal(frame, HEATMAP_WRITE);
+	case COUNTER_FETCHES:
+		return heatmap->getTotal(frame, HEATMAP_FETCH);
+	case COUNTER_DMA:
+		return heatmap->getDMACount(frame);
+	default:
+		return (heatmap->getTotal(frame, HEATMAP_READ) +
+		        heatmap->getTotal(frame, HEATMAP_WRITE) +
+		        heatmap->getTotal(frame, HEATMAP_FETCH) +
+		        heatmap->getDMACount(frame));
+	}
+}
+
+int HeatmapView::frameAt(const QPoint& pos) const
+{
+	if (pos.y() < kGridTop || pos.x() >= kColumns * kCellSize)
+		return -1;
+	int frame = ((pos.y() - kGridTop) / kCellSize) * kColumns + pos.x() / kCellSize;
+	return frame < (int) counts.size() ? frame : -1;
+}
+
+void HeatmapView::paintEvent(QPaintEvent*)
+{
+	QPainter painter(this);
+	double scale = maxCount > 0 ? std::log(maxCount + 1.0) : 1.0;
+
+	for (unsigned int frame = 0; frame < counts.size(); frame++) {
+		QRect cell((frame % kColumns) * kCellSize, kGridTop + (frame / kColumns) * kCellSize,
+		           kCellSize, kCellSize);
+		// From blue (cold) to red (hot); white if never accessed
+		QColor color = Qt::white;
+		if (counts[frame] > 0) {
+			double heat = std::log(counts[frame] + 1.0) / scale;
+			color = QColor::fromHsvF((1.0 - heat) * 2.0 / 3.0, 0.85, 0.95);
+		}
+		painter.fillRect(cell, color);
+		painter.setPen(palette().color(QPalette::Mid));
+		painter.drawRect(cell);
+	}
+}
+
+bool HeatmapView::event(QEvent* event)
+{
+	if (event->type() == QEvent::ToolTip) {
+		QHelpEvent* helpEvent = static_cast<QHelpEvent*>(event);
+		int frame = frameAt(helpEvent->pos());
+		if (frame < 0 || heatmap == NULL) {
+			QToolTip::hideText();
+			event->ignore();
+			return true;
+		}
+		QToolTip::showText(helpEvent->globalPos(),
+		                   QString("Frame %1 (%2)\nReads: %3\nWrites: %4\nFetches: %5\nDMA: %6")
+		                   .arg(frame)
+		                   .arg(FormatAddress(RAMBASE + frame * FRAMESIZE * WS))
+		                   .arg(heatmap->getTotal(frame, HEATMAP_READ))
+		                   .arg(heatmap->getTotal(frame, HEATMAP_WRITE))
+		                   .arg(heatmap->getTotal(frame, HEATMAP_FETCH))
+		                   .arg(heatmap->getDMACount(frame)));
+		return true;
+	}
+	return QWidget::event(event);
+}
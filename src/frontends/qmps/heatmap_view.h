@@ -0,0 +1,81 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef QMPS_HEATMAP_VIEW_H
+#define QMPS_HEATMAP_VIEW_H
+
+#include <vector>
+
+#include <QWidget>
+
+#include "umps/types.h"
+
+class QComboBox;
+class QLabel;
+class DebugSession;
+class MemoryHeatmap;
+
+// A grid of RAM frames, each colored after the number of accesses it
+// got (on a logarithmic scale), as counted by the machine heatmap
+class HeatmapView: public QWidget {
+	Q_OBJECT
+
+public:
+	HeatmapView(QWidget* parent = 0);
+
+	QSize sizeHint() const;
+
+protected:
+	void paintEvent(QPaintEvent* event);
+	bool event(QEvent* event);
+
+private Q_SLOTS:
+	void onMachineStarted();
+	void onMachineHalted();
+	void refreshView();
+
+private:
+	static const int kCellSize = 10;
+	static const int kColumns = 32;
+
+	enum Counter {
+		COUNTER_ALL,
+		COUNTER_READS,
+		COUNTER_WRITES,
+		COUNTER_FETCHES,
+		COUNTER_DMA
+	};
+
+	uint64_t count(unsigned int frame, int counter) const;
+	int frameAt(const QPoint& pos) const;
+
+	DebugSession* const dbgSession;
+	MemoryHeatmap* heatmap;
+
+	QComboBox* counterCombo;
+	QLabel* placeholder;
+
+	// Counts shown, for the counter selected
+	std::vector<uint64_t> counts;
+	uint64_t maxCount;
+};
+
+#endif // QMPS_HEATMAP_VIEW_H
@@ -0,0 +1,94 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "qmps/lock_stats_view.h"
+
+#include <QLabel>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "umps/machine.h"
+#include "umps/lock_stats.h"
+#include "umps/symbol_table.h"
+#include "qmps/application.h"
+#include "qmps/debug_session.h"
+#include "qmps/ui_utils.h"
+
+LockStatsView::LockStatsView(QWidget* parent)
+	: QWidget(parent),
+	dbgSession(Appl()->getDebugSession()),
+	stats(NULL)
+{
+	QVBoxLayout* layout = new QVBoxLayout(this);
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->addWidget(new QLabel("<b>Lock Contention</b>"));
+
+	lockView = new QTreeWidget;
+	lockView->setRootIsDecorated(false);
+	lockView->setAlternatingRowColors(true);
+	lockView->setHeaderLabels(QStringList() << "Address" << "Symbol" << "Attempts"
+	                          << "Failures" << "Contended" << "Spin Cycles" << "Max Spin");
+	layout->addWidget(lockView);
+
+	connect(dbgSession, SIGNAL(MachineStarted()), this, SLOT(onMachineStarted()));
+	connect(dbgSession, SIGNAL(MachineReset()), this, SLOT(onMachineStarted()));
+	connect(dbgSession, SIGNAL(MachineHalted()), this, SLOT(onMachineHalted()));
+	connect(dbgSession, SIGNAL(DebugIterationCompleted()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineStopped()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineRan()), this, SLOT(refreshView()));
+}
+
+void LockStatsView::onMachineStarted()
+{
+	stats = dbgSession->getMachine()->getLockStats();
+	refreshView();
+}
+
+void LockStatsView::onMachineHalted()
+{
+	stats = NULL;
+	lockView->clear();
+}
+
+void LockStatsView::refreshView()
+{
+	if (stats == NULL)
+		return;
+
+	// Kernel code runs unmapped: lock addresses are kernel symbols
+	const SymbolTable* stab = dbgSession->getSymbolTable();
+
+	lockView->clear();
+	for (const LockStats::Lock& l : stats->getTopLocks(kTopLocks)) {
+		QString symbol;
+		SWord offset;
+		const char* name = NULL;
+		if (stab != NULL)
+			name = GetSymbolicAddress(stab, MAXASID, l.addr, false, &offset);
+		if (name != NULL)
+			symbol = offset ? QString("%1+0x%2").arg(name).arg(offset, 0, 16) : QString(name);
+
+		QStringList columns;
+		columns << FormatAddress(l.addr) << symbol << QString::number(l.attempts)
+		        << QString::number(l.failures) << QString::number(l.contended)
+		        << QString::number(l.spinCycles) << QString::number(l.maxSpin);
+		lockView->addTopLevelItem(new QTreeWidgetItem(columns));
+	}
+}
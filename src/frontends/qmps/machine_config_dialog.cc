@@ -59,6 +59,8 @@ MachineConfigDialog::MachineConfigDialog(MachineConfig* config, QWidget* parent)
 	QTabWidget* tabWidget = new QTabWidget;
 	tabWidget->addTab(createGeneralTab(), "&General");
 	tabWidget->addTab(createDeviceTab(), "&Devices");
+	tabWidget->addTab(createProfilingTab(), "&Profiling");
+	tabWidget->addTab(createCacheTab(), "Ca&ches");
 
 	QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok |
 	                                                   QDialogButtonBox::Cancel);
@@ -271,6 +273,212 @@ QWidget* MachineConfigDialog::createDeviceTab()
 	return tab;
 }
 
+QWidget* MachineConfigDialog::createProfilingTab()
+{
+	QWidget* tabWidget = new QWidget;
+	QGridLayout* layout = new QGridLayout(tabWidget);
+	layout->setContentsMargins(11, 13, 11, 11);
+
+	layout->addWidget(new QLabel("<b>Sampling Profiler</b>"), 0, 0, 1, 3);
+
+	layout->addWidget(new QLabel("Profile File:"), 1, 1);
+	samplingFileEdit = new QLineEdit;
+	samplingFileEdit->setText(config->getSamplingFile().c_str());
+	layout->addWidget(samplingFileEdit, 1, 3, 1, 2);
+	QPushButton* fileChooserButton = new QPushButton("Browse...");
+	connect(fileChooserButton, SIGNAL(clicked()), this, SLOT(getSamplingFileName()));
+	layout->addWidget(fileChooserButton, 1, 5);
+
+	layout->addWidget(new QLabel("Interval (Cycles):"), 2, 1);
+	samplingIntervalSpinner = new QSpinBox();
+	samplingIntervalSpinner->setMinimum(MachineConfig::MIN_SAMPLING_INTERVAL);
+	samplingIntervalSpinner->setMaximum(MachineConfig::MAX_SAMPLING_INTERVAL);
+	samplingIntervalSpinner->setValue(config->getSamplingInterval());
+	layout->addWidget(samplingIntervalSpinner, 2, 3);
+
+	layout->addWidget(new QLabel("<b>Call Graph Profiler</b>"), 4, 0, 1, 3);
+
+	layout->addWidget(new QLabel("Callgrind File:"), 5, 1);
+	callGraphFileEdit = new QLineEdit;
+	callGraphFileEdit->setText(config->getCallGraphFile().c_str());
+	layout->addWidget(callGraphFileEdit, 5, 3, 1, 2);
+	fileChooserButton = new QPushButton("Browse...");
+	connect(fileChooserButton, SIGNAL(clicked()), this, SLOT(getCallGraphFileName()));
+	layout->addWidget(fileChooserButton, 5, 5);
+
+	layout->addWidget(new QLabel("<b>Code Coverage</b>"), 7, 0, 1, 3);
+
+	layout->addWidget(new QLabel("Lcov File:"), 8, 1);
+	coverageFileEdit = new QLineEdit;
+	coverageFileEdit->setText(config->getCoverageFile().c_str());
+	layout->addWidget(coverageFileEdit, 8, 3, 1, 2);
+	fileChooserButton = new QPushButton("Browse...");
+	connect(fileChooserButton, SIGNAL(clicked()), this, SLOT(getCoverageFileName()));
+	layout->addWidget(fileChooserButton, 8, 5);
+
+	coverageMergeCheckBox = new QCheckBox("Merge with previous runs");
+	coverageMergeCheckBox->setChecked(config->isCoverageMergeEnabled());
+	layout->addWidget(coverageMergeCheckBox, 9, 1, 1, 3);
+
+	layout->addWidget(new QLabel("<b>Memory Heatmap</b>"), 11, 0, 1, 3);
+
+	heatmapCheckBox = new QCheckBox("Count accesses to memory frames");
+	heatmapCheckBox->setChecked(config->isHeatmapEnabled());
+	layout->addWidget(heatmapCheckBox, 12, 1, 1, 3);
+
+	layout->addWidget(new QLabel("CSV/JSON File:"), 13, 1);
+	heatmapFileEdit = new QLineEdit;
+	heatmapFileEdit->setText(config->getHeatmapFile().c_str());
+	layout->addWidget(heatmapFileEdit, 13, 3, 1, 2);
+	fileChooserButton = new QPushButton("Browse...");
+	connect(fileChooserButton, SIGNAL(clicked()), this, SLOT(getHeatmapFileName()));
+	layout->addWidget(fileChooserButton, 13, 5);
+
+	layout->addWidget(new QLabel("Counters:"), 14, 1);
+	heatmapSplitList = new QComboBox;
+	heatmapSplitList->addItem("All processors together");
+	heatmapSplitList->addItem("One set per processor");
+	heatmapSplitList->addItem("One set per ASID");
+	heatmapSplitList->setCurrentIndex(config->getHeatmapSplit());
+	layout->addWidget(heatmapSplitList, 14, 3);
+
+	layout->addWidget(new QLabel("<b>Timeline</b>"), 16, 0, 1, 3);
+
+	layout->addWidget(new QLabel("Trace Event File:"), 17, 1);
+	timelineFileEdit = new QLineEdit;
+	timelineFileEdit->setText(config->getTimelineFile().c_str());
+	layout->addWidget(timelineFileEdit, 17, 3, 1, 2);
+	fileChooserButton = new QPushButton("Browse...");
+	connect(fileChooserButton, SIGNAL(clicked()), this, SLOT(getTimelineFileName()));
+	layout->addWidget(fileChooserButton, 17, 5);
+
+	layout->addWidget(new QLabel("<b>Metrics Stream</b>"), 19, 0, 1, 3);
+
+	layout->addWidget(new QLabel("File or Socket:"), 20, 1);
+	metricsFileEdit = new QLineEdit;
+	metricsFileEdit->setText(config->getMetricsFile().c_str());
+	layout->addWidget(metricsFileEdit, 20, 3, 1, 2);
+	fileChooserButton = new QPushButton("Browse...");
+	connect(fileChooserButton, SIGNAL(clicked()), this, SLOT(getMetricsFileName()));
+	layout->addWidget(fileChooserButton, 20, 5);
+
+	layout->addWidget(new QLabel("Format:"), 21, 1);
+	metricsFormatList = new QComboBox;
+	metricsFormatList->addItem("JSON lines");
+	metricsFormatList->addItem("CSV");
+	metricsFormatList->setCurrentIndex(config->getMetricsFormat());
+	layout->addWidget(metricsFormatList, 21, 3);
+
+	layout->addWidget(new QLabel("Interval:"), 22, 1);
+	metricsIntervalSpinner = new QSpinBox();
+	metricsIntervalSpinner->setMinimum(MachineConfig::MIN_METRICS_INTERVAL);
+	metricsIntervalSpinner->setMaximum(MachineConfig::MAX_METRICS_INTERVAL);
+	metricsIntervalSpinner->setValue(config->getMetricsInterval());
+	layout->addWidget(metricsIntervalSpinner, 22, 3);
+	metricsClockList = new QComboBox;
+	metricsClockList->addItem("Milliseconds (host time)");
+	metricsClockList->addItem("Cycles (guest time)");
+	metricsClockList->setCurrentIndex(config->getMetricsClock());
+	layout->addWidget(metricsClockList, 22, 4);
+
+	layout->setColumnMinimumWidth(0, 10);
+	layout->setColumnMinimumWidth(2, 10);
+	layout->setColumnMinimumWidth(3, 100);
+	layout->setColumnMinimumWidth(5, 75);
+
+	layout->setRowMinimumHeight(3, 11);
+	layout->setRowMinimumHeight(6, 11);
+	layout->setRowMinimumHeight(10, 11);
+	layout->setRowMinimumHeight(15, 11);
+	layout->setRowMinimumHeight(18, 11);
+
+	layout->setRowStretch(23, 1);
+	layout->setColumnStretch(4, 1);
+
+	return tabWidget;
+}
+
+QWidget* MachineConfigDialog::createCacheTab()
+{
+	static const char* const levelName[N_CACHE_LEVELS] = {
+		"L1 Instruction:", "L1 Data:", "L2 (Shared):"
+	};
+
+	QWidget* tabWidget = new QWidget;
+	QGridLayout* layout = new QGridLayout(tabWidget);
+	layout->setContentsMargins(11, 13, 11, 11);
+
+	cacheModelCheckBox = new QCheckBox("Simulate caches");
+	cacheModelCheckBox->setChecked(config->isCacheModelEnabled());
+	layout->addWidget(cacheModelCheckBox, 0, 0, 1, 4);
+
+	layout->addWidget(new QLabel("<b>Geometry</b>"), 2, 0, 1, 2);
+	layout->addWidget(new QLabel("Size (KB):"), 3, 3);
+	layout->addWidget(new QLabel("Ways:"), 3, 4);
+	layout->addWidget(new QLabel("Line (Bytes):"), 3, 5);
+
+	for (unsigned int i = 0; i < N_CACHE_LEVELS; i++) {
+		CacheLevel level = (CacheLevel) i;
+		layout->addWidget(new QLabel(levelName[i]), 4 + i, 1);
+
+		cacheSizeSpinner[i] = new QSpinBox();
+		cacheSizeSpinner[i]->setMinimum(MachineConfig::MIN_CACHE_SIZE);
+		cacheSizeSpinner[i]->setMaximum(MachineConfig::MAX_CACHE_SIZE);
+		cacheSizeSpinner[i]->setSpecialValueText("None");
+		cacheSizeSpinner[i]->setValue(config->getCacheSize(level));
+		layout->addWidget(cacheSizeSpinner[i], 4 + i, 3);
+
+		cacheWaysSpinner[i] = new QSpinBox();
+		cacheWaysSpinner[i]->setMinimum(MachineConfig::MIN_CACHE_WAYS);
+		cacheWaysSpinner[i]->setMaximum(MachineConfig::MAX_CACHE_WAYS);
+		cacheWaysSpinner[i]->setValue(config->getCacheWays(level));
+		layout->addWidget(cacheWaysSpinner[i], 4 + i, 4);
+
+		cacheLineList[i] = new QComboBox;
+		int currentIndex = 0;
+		for (unsigned int size = MachineConfig::MIN_CACHE_LINE, j = 0;
+		     size <= MachineConfig::MAX_CACHE_LINE; size <<= 1, j++)
+		{
+			cacheLineList[i]->addItem(QString::number(size));
+			if (config->getCacheLineSize(level) == size)
+				currentIndex = j;
+		}
+		cacheLineList[i]->setCurrentIndex(currentIndex);
+		layout->addWidget(cacheLineList[i], 4 + i, 5);
+	}
+
+	layout->addWidget(new QLabel("<b>Timing</b>"), 8, 0, 1, 2);
+
+	layout->addWidget(new QLabel("L2 Latency (Cycles):"), 9, 1);
+	l2LatencySpinner = new QSpinBox();
+	l2LatencySpinner->setMinimum(MachineConfig::MIN_CACHE_LATENCY);
+	l2LatencySpinner->setMaximum(MachineConfig::MAX_CACHE_LATENCY);
+	l2LatencySpinner->setValue(config->getL2Latency());
+	layout->addWidget(l2LatencySpinner, 9, 3);
+
+	layout->addWidget(new QLabel("Memory Latency (Cycles):"), 10, 1);
+	memoryLatencySpinner = new QSpinBox();
+	memoryLatencySpinner->setMinimum(MachineConfig::MIN_CACHE_LATENCY);
+	memoryLatencySpinner->setMaximum(MachineConfig::MAX_CACHE_LATENCY);
+	memoryLatencySpinner->setValue(config->getMemoryLatency());
+	layout->addWidget(memoryLatencySpinner, 10, 3);
+
+	cacheStallCheckBox = new QCheckBox("Stall processors on misses");
+	cacheStallCheckBox->setChecked(config->isCacheStallEnabled());
+	layout->addWidget(cacheStallCheckBox, 11, 1, 1, 4);
+
+	layout->setColumnMinimumWidth(0, 10);
+	layout->setColumnMinimumWidth(2, 10);
+
+	layout->setRowMinimumHeight(1, 11);
+	layout->setRowMinimumHeight(7, 11);
+
+	layout->setRowStretch(12, 1);
+	layout->setColumnStretch(6, 1);
+
+	return tabWidget;
+}
+
 void MachineConfigDialog::registerDeviceClass(const QString& label,
                                               const QString& icon,
                                               unsigned int devClassIndex,
@@ -303,6 +511,50 @@ void MachineConfigDialog::getROMFileName(int index)
 		romFileInfo[index].lineEdit->setText(fileName);
 }
 
+void MachineConfigDialog::getSamplingFileName()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Select Sampling Profile File");
+	if (!fileName.isEmpty())
+		samplingFileEdit->setText(fileName);
+}
+
+void MachineConfigDialog::getCallGraphFileName()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Select Callgrind File");
+	if (!fileName.isEmpty())
+		callGraphFileEdit->setText(fileName);
+}
+
+void MachineConfigDialog::getTimelineFileName()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Select Timeline File");
+	if (!fileName.isEmpty())
+		timelineFileEdit->setText(fileName);
+}
+
+void MachineConfigDialog::getMetricsFileName()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Select Metrics File", QString(), QString(),
+	                                                NULL, QFileDialog::DontConfirmOverwrite);
+	if (!fileName.isEmpty())
+		metricsFileEdit->setText(fileName);
+}
+
+void MachineConfigDialog::getCoverageFileName()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Select Coverage File", QString(), QString(),
+	                                                NULL, QFileDialog::DontConfirmOverwrite);
+	if (!fileName.isEmpty())
+		coverageFileEdit->setText(fileName);
+}
+
+void MachineConfigDialog::getHeatmapFileName()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Select Heatmap File");
+	if (!fileName.isEmpty())
+		heatmapFileEdit->setText(fileName);
+}
+
 void MachineConfigDialog::onDeviceClassChanged()
 {
 	QList<QListWidgetItem*> selected = devClassView->selectedItems();
@@ -329,6 +581,31 @@ void MachineConfigDialog::saveConfigChanges()
 
 	config->setLoadCoreEnabled(coreBootCheckBox->isChecked());
 	config->setSymbolTableASID(stabAsidEdit->getAsid());
+
+	config->setSamplingFile(QFile::encodeName(samplingFileEdit->text()).constData());
+	config->setSamplingInterval(samplingIntervalSpinner->value());
+	config->setCallGraphFile(QFile::encodeName(callGraphFileEdit->text()).constData());
+	config->setCoverageFile(QFile::encodeName(coverageFileEdit->text()).constData());
+	config->setTimelineFile(QFile::encodeName(timelineFileEdit->text()).constData());
+	config->setMetricsFile(QFile::encodeName(metricsFileEdit->text()).constData());
+	config->setMetricsFormat((MetricsFormat) metricsFormatList->currentIndex());
+	config->setMetricsInterval(metricsIntervalSpinner->value());
+	config->setMetricsClock((MetricsClock) metricsClockList->currentIndex());
+	config->setCoverageMergeEnabled(coverageMergeCheckBox->isChecked());
+	config->setHeatmapEnabled(heatmapCheckBox->isChecked());
+	config->setHeatmapFile(QFile::encodeName(heatmapFileEdit->text()).constData());
+	config->setHeatmapSplit((HeatmapSplit) heatmapSplitList->currentIndex());
+
+	config->setCacheModelEnabled(cacheModelCheckBox->isChecked());
+	for (unsigned int i = 0; i < N_CACHE_LEVELS; i++) {
+		config->setCacheSize((CacheLevel) i, cacheSizeSpinner[i]->value());
+		config->setCacheWays((CacheLevel) i, cacheWaysSpinner[i]->value());
+		config->setCacheLineSize((CacheLevel) i,
+		                         MachineConfig::MIN_CACHE_LINE << cacheLineList[i]->currentIndex());
+	}
+	config->setL2Latency(l2LatencySpinner->value());
+	config->setMemoryLatency(memoryLatencySpinner->value());
+	config->setCacheStallEnabled(cacheStallCheckBox->isChecked());
 }
 
 DeviceFileChooser::DeviceFileChooser(const QString& deviceClassName,
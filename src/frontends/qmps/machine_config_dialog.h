@@ -43,6 +43,8 @@ MachineConfigDialog(MachineConfig* config, QWidget* parent = 0);
 private:
 QWidget* createGeneralTab();
 QWidget* createDeviceTab();
+QWidget* createProfilingTab();
+QWidget* createCacheTab();
 void registerDeviceClass(const QString& label,
                          const QString& icon,
                          unsigned int devClassIndex,
@@ -68,8 +70,36 @@ struct {
 QListWidget* devClassView;
 QStackedLayout* devFileChooserStack;
 
+QLineEdit* samplingFileEdit;
+QSpinBox* samplingIntervalSpinner;
+QLineEdit* callGraphFileEdit;
+QLineEdit* coverageFileEdit;
+QLineEdit* timelineFileEdit;
+QLineEdit* metricsFileEdit;
+QComboBox* metricsFormatList;
+QSpinBox* metricsIntervalSpinner;
+QComboBox* metricsClockList;
+QCheckBox* coverageMergeCheckBox;
+QCheckBox* heatmapCheckBox;
+QLineEdit* heatmapFileEdit;
+QComboBox* heatmapSplitList;
+
+QCheckBox* cacheModelCheckBox;
+QSpinBox* cacheSizeSpinner[N_CACHE_LEVELS];
+QSpinBox* cacheWaysSpinner[N_CACHE_LEVELS];
+QComboBox* cacheLineList[N_CACHE_LEVELS];
+QSpinBox* l2LatencySpinner;
+QSpinBox* memoryLatencySpinner;
+QCheckBox* cacheStallCheckBox;
+
 private Q_SLOTS:
 void getROMFileName(int index);
+void getSamplingFileName();
+void getCallGraphFileName();
+void getTimelineFileName();
+void getMetricsFileName();
+void getCoverageFileName();
+void getHeatmapFileName();
 
 void onDeviceClassChanged();
 
@@ -47,6 +47,10 @@
 #include "qmps/flat_push_button.h"
 #include "qmps/create_machine_dialog.h"
 #include "qmps/trace_browser.h"
+#include "qmps/heatmap_view.h"
+#include "qmps/tlb_stats_view.h"
+#include "qmps/lock_stats_view.h"
+#include "qmps/cycle_account_view.h"
 #include "qmps/processor_window.h"
 #include "qmps/terminal_window.h"
 #include "qmps/monitor_window_priv.h"
@@ -467,6 +471,9 @@ QWidget* MonitorWindow::createCpuTab()
 	splitter->setChildrenCollapsible(false);
 	splitter->addWidget(cpuListView);
 	splitter->addWidget(breakpointListView);
+	splitter->addWidget(new CycleAccountView);
+	splitter->addWidget(new TLBStatsView);
+	splitter->addWidget(new LockStatsView);
 
 	return splitter;
 }
@@ -489,6 +496,7 @@ QWidget* MonitorWindow::createMemoryTab()
 	splitter->addWidget(suspectListView);
 	traceBrowser = new TraceBrowser(addTraceAction, removeTraceAction);
 	splitter->addWidget(traceBrowser);
+	splitter->addWidget(new HeatmapView);
 
 	return splitter;
 }
@@ -0,0 +1,109 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "qmps/tlb_stats_view.h"
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QSplitter>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "umps/machine.h"
+#include "umps/tlb_stats.h"
+#include "qmps/application.h"
+#include "qmps/debug_session.h"
+#include "qmps/ui_utils.h"
+
+TLBStatsView::TLBStatsView(QWidget* parent)
+	: QWidget(parent),
+	dbgSession(Appl()->getDebugSession()),
+	stats(NULL)
+{
+	QVBoxLayout* layout = new QVBoxLayout(this);
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->addWidget(new QLabel("<b>TLB Statistics</b>"));
+
+	asidView = new QTreeWidget;
+	asidView->setRootIsDecorated(false);
+	asidView->setAlternatingRowColors(true);
+	asidView->setHeaderLabels(QStringList() << "ASID" << "Refills" << "Invalid"
+	                          << "Modified" << "Writes" << "Live Evictions");
+
+	pageView = new QTreeWidget;
+	pageView->setRootIsDecorated(false);
+	pageView->setAlternatingRowColors(true);
+	pageView->setHeaderLabels(QStringList() << "ASID" << "Page" << "Faults");
+
+	QSplitter* splitter = new QSplitter(Qt::Horizontal);
+	splitter->addWidget(asidView);
+	splitter->addWidget(pageView);
+	layout->addWidget(splitter);
+
+	connect(dbgSession, SIGNAL(MachineStarted()), this, SLOT(onMachineStarted()));
+	connect(dbgSession, SIGNAL(MachineReset()), this, SLOT(onMachineStarted()));
+	connect(dbgSession, SIGNAL(MachineHalted()), this, SLOT(onMachineHalted()));
+	connect(dbgSession, SIGNAL(DebugIterationCompleted()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineStopped()), this, SLOT(refreshView()));
+	connect(dbgSession, SIGNAL(MachineRan()), this, SLOT(refreshView()));
+}
+
+void TLBStatsView::onMachineStarted()
+{
+	stats = dbgSession->getMachine()->getTLBStats();
+	refreshView();
+}
+
+void TLBStatsView::onMachineHalted()
+{
+	stats = NULL;
+	asidView->clear();
+	pageView->clear();
+}
+
+void TLBStatsView::refreshView()
+{
+	if (stats == NULL)
+		return;
+
+	// Only ASIDs with some event are listed
+	asidView->clear();
+	for (Word asid = 0; asid < MAXASID; asid++) {
+		QStringList columns;
+		uint64_t events = 0;
+		columns << QString::number(asid, 16);
+		for (unsigned int i = 0; i < N_TLB_EVENTS; i++) {
+			uint64_t n = stats->getCount(asid, (TLBEvent) i);
+			columns << QString::number(n);
+			events += n;
+		}
+		if (events > 0)
+			asidView->addTopLevelItem(new QTreeWidgetItem(columns));
+	}
+
+	pageView->clear();
+	for (const TLBStats::PageFaults& pf : stats->getTopFaults(kTopPages)) {
+		QStringList columns;
+		columns << QString::number(pf.asid, 16) << FormatAddress(pf.vpn)
+		        << QString::number(pf.faults);
+		pageView->addTopLevelItem(new QTreeWidgetItem(columns));
+	}
+}
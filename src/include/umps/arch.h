@@ -124,17 +124,28 @@
 
 #define IRT_ENTRY(line, dev)    (IRT_BASE + WS * (((line) - IL_TIMER) * N_DEV_PER_IL + dev))
 
-#define     IRT_ENTRY_POLICY_MASK       0x10000000
+#define     IRT_ENTRY_POLICY_MASK       0x30000000
 #define     IRT_ENTRY_POLICY_BIT        28
 #define     IRT_ENTRY_GET_POLICY(x)     (((x) & IRT_ENTRY_POLICY_MASK) >> IRT_ENTRY_POLICY_BIT)
 
+/* Load-aware routing: keep interrupts on the cpu which took the last one */
+#define     IRT_ENTRY_STICKY_MASK       0x40000000
+#define     IRT_ENTRY_STICKY_BIT        30
+#define     IRT_ENTRY_GET_STICKY(x)     (((x) & IRT_ENTRY_STICKY_MASK) >> IRT_ENTRY_STICKY_BIT)
+
 #define     IRT_ENTRY_DEST_MASK         0x0000ffff
 #define     IRT_ENTRY_DEST_BIT          0
 #define     IRT_ENTRY_GET_DEST(x)       (((x) & IRT_ENTRY_DEST_MASK) >> IRT_ENTRY_DEST_BIT)
 
+/* Dynamic routing: the destination set covers cpus 16*group..16*group+15 */
+#define     IRT_ENTRY_GROUP_MASK        0x00030000
+#define     IRT_ENTRY_GROUP_BIT         16
+#define     IRT_ENTRY_GET_GROUP(x)      (((x) & IRT_ENTRY_GROUP_MASK) >> IRT_ENTRY_GROUP_BIT)
+
 /* Interrupt routing policies */
 #define IRT_POLICY_FIXED   0
 #define IRT_POLICY_DYNAMIC 1
+#define IRT_POLICY_LOAD    2
 
 /*
  * Int. controller cpu inteface (banked) register set
@@ -145,7 +156,7 @@
 #define     CPUCTL_INBOX_MSG_BIT        0
 #define     CPUCTL_INBOX_GET_MSG(x)     (((x) & CPUCTL_INBOX_MSG_MASK) >> CPUCTL_INBOX_MSG_BIT)
 
-#define     CPUCTL_INBOX_ORIGIN_MASK    0x00000f00
+#define     CPUCTL_INBOX_ORIGIN_MASK    0x00003f00
 #define     CPUCTL_INBOX_ORIGIN_BIT     8
 #define     CPUCTL_INBOX_GET_ORIGIN(x)  (((x) & CPUCTL_INBOX_ORIGIN_MASK) >> CPUCTL_INBOX_ORIGIN_BIT)
 
@@ -159,6 +170,11 @@
 #define     CPUCTL_OUTBOX_RECIP_BIT     8
 #define     CPUCTL_OUTBOX_GET_RECIP(x)  (((x) & CPUCTL_OUTBOX_RECIP_MASK) >> CPUCTL_OUTBOX_RECIP_BIT)
 
+/* Recipients are cpus 16*group..16*group+15 */
+#define     CPUCTL_OUTBOX_GROUP_MASK    0x03000000
+#define     CPUCTL_OUTBOX_GROUP_BIT     24
+#define     CPUCTL_OUTBOX_GET_GROUP(x)  (((x) & CPUCTL_OUTBOX_GROUP_MASK) >> CPUCTL_OUTBOX_GROUP_BIT)
+
 #define CPUCTL_TPR              0x10000408
 
 #define     CPUCTL_TPR_PRIORITY_MASK    0x0000000f
@@ -166,8 +182,22 @@
 #define CPUCTL_BIOS_RES_0       0x1000040c
 #define CPUCTL_BIOS_RES_1       0x10000410
 
+/*
+ * Performance counters (read-only): each cpu reads its own. Counters
+ * are reset with the cpu and wrap around at 2^32.
+ */
+#define CPUCTL_PERF_CYCLES      0x10000414
+#define CPUCTL_PERF_INSTRS      0x10000418
+#define CPUCTL_PERF_TLB_REFILLS 0x1000041c
+#define CPUCTL_PERF_EXCEPTIONS  0x10000420
+#define CPUCTL_PERF_INTERRUPTS  0x10000424
+#define CPUCTL_PERF_IDLE        0x10000428
+
+#define CPUCTL_PERF_BASE        CPUCTL_PERF_CYCLES
+#define CPUCTL_PERF_END         (CPUCTL_PERF_IDLE + WS)
+
 #define CPUCTL_BASE             CPUCTL_INBOX
-#define CPUCTL_END              (CPUCTL_BIOS_RES_1 + WS)
+#define CPUCTL_END              CPUCTL_PERF_END
 
 /*
  * Machine control registers
@@ -175,7 +205,7 @@
 #define MCTL_NCPUS              0x10000500
 
 #define MCTL_RESET_CPU          0x10000504
-#define     MCTL_RESET_CPU_CPUID_MASK   0x0000000f
+#define     MCTL_RESET_CPU_CPUID_MASK   0x0000003f
 
 /* Reset vector and initial $sp */
 #define MCTL_BOOT_PC            0x10000508
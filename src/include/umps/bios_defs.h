@@ -39,5 +39,13 @@
 #define BIOS_DATA_PAGE_BASE	    0x0FFFF000
 #define BIOS_EXEC_HANDLERS_ADDRS    0x0FFFF900
 
+/*
+ * The data page only holds the exception state vectors of the first
+ * BIOS_DATA_PAGE_CPUS processors; those of the other ones are kept in
+ * the extended BIOS data area, just below the data page.
+ */
+#define BIOS_DATA_PAGE_CPUS	    16
+#define BIOS_EXT_DATA_BASE	    0x0FFFC000
+
 
 #endif /* BIOS_DEFS_H */
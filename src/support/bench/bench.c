@@ -0,0 +1,141 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * This module contains the runtime shared by the guest benchmark
+ * kernels (see bench.h).
+ *
+ ****************************************************************************/
+
+#include "bench.h"
+
+#define BYTELEN         8
+#define STATUSMASK      0xFF
+
+/* Performance counters at benchStart() */
+HIDDEN unsigned int startCycles;
+HIDDEN unsigned int startInstrs;
+
+HIDDEN void printNum(unsigned int n);
+
+HIDDEN unsigned int ramTop(void)
+{
+	return *((volatile unsigned int *) BUS_REG_RAM_BASE) + *((volatile unsigned int *) BUS_REG_RAM_SIZE);
+}
+
+unsigned int benchHandlerStack(unsigned int cpu)
+{
+	return ramTop() - cpu * PAGESIZE;
+}
+
+unsigned int benchProcessStack(unsigned int cpu)
+{
+	return ramTop() - (BENCH_MAX_CPUS + cpu) * PAGESIZE;
+}
+
+unsigned int benchScratch(unsigned int size)
+{
+	size = (size + PAGESIZE - 1) & ~(PAGESIZE - 1);
+	return ramTop() - 2 * BENCH_MAX_CPUS * PAGESIZE - size;
+}
+
+void benchInit(void)
+{
+	setSTATUS(getSTATUS() & ~(STATUS_IEc | STATUS_IM_MASK));
+	setTIMER(0xFFFFFFFF);
+	*((volatile unsigned int *) BUS_REG_TIMER) = 0xFFFFFFFF;
+}
+
+void benchSetHandlers(unsigned int cpu, void (*tlbRefill)(void), void (*exception)(void))
+{
+	passupvector_t *pv = (passupvector_t *) BIOS_EXEC_HANDLERS_ADDRS + cpu;
+
+	pv->tlb_refill_handler = (unsigned int) (tlbRefill != NULL ? tlbRefill : benchUnexpected);
+	pv->tlb_refill_stackPtr = benchHandlerStack(cpu);
+	pv->exception_handler = (unsigned int) (exception != NULL ? exception : benchUnexpected);
+	pv->exception_stackPtr = benchHandlerStack(cpu);
+}
+
+void benchUnexpected(void)
+{
+	PANIC();
+}
+
+unsigned int benchDevCommand(volatile unsigned int *command, volatile unsigned int *status,
+                             unsigned int value)
+{
+	unsigned int result;
+
+	*command = value;
+	/* WAIT returns at once while an interrupt is pending, masked or
+	   not, so this cannot miss the completion */
+	while ((*status & STATUSMASK) == DEV_BUSY)
+		WAIT();
+	result = *status & STATUSMASK;
+	*command = DEV_ACK;
+	return result;
+}
+
+void benchPrint(const char *s)
+{
+	volatile devreg_t *term = BENCH_DEVREG(IL_TERMINAL, 0);
+
+	for (; *s != '\0'; s++)
+		benchDevCommand(&term->term.transm_command, &term->term.transm_status,
+		                ((unsigned int) *s << BYTELEN) | TERM_TRANSMIT);
+}
+
+HIDDEN void printNum(unsigned int n)
+{
+	char buf[12];
+	int i = sizeof(buf) - 1;
+
+	buf[i] = '\0';
+	do {
+		buf[--i] = '0' + n % 10;
+		n /= 10;
+	} while (n > 0);
+	benchPrint(&buf[i]);
+}
+
+void benchStart(void)
+{
+	startCycles = getPERFCYCLES();
+	startInstrs = getPERFINSTRS();
+}
+
+void benchDone(const char *name)
+{
+	unsigned int cycles = getPERFCYCLES() - startCycles;
+	unsigned int instrs = getPERFINSTRS() - startInstrs;
+
+	setSTATUS(getSTATUS() & ~STATUS_IEc);
+	benchPrint(name);
+	benchPrint(": ");
+	printNum(cycles);
+	benchPrint(" cycles, ");
+	printNum(instrs);
+	benchPrint(" instructions\n");
+
+	*((volatile unsigned int *) MCTL_POWER) = 0x0FF;
+	for (;;)
+		WAIT();
+}
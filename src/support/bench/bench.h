@@ -0,0 +1,101 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * This header file contains definitions shared by the guest benchmark
+ * kernels: memory layout, device commands and the small runtime each
+ * kernel links against (see bench.c).
+ *
+ * Kernels run on bare metal, started by crtso.o: main() sets up the
+ * pass up vector it needs, calls benchStart() before the measured
+ * workload and benchDone() after it, which reports the cycles and
+ * instructions taken on terminal 0 and powers the machine off.
+ *
+ ****************************************************************************/
+
+#ifndef UMPS_BENCH_H
+#define UMPS_BENCH_H
+
+#include <umps/arch.h>
+#include <umps/cp0.h>
+#include <umps/bios_defs.h>
+
+#include "libumps.h"
+#include "types.h"
+
+#define HIDDEN          static
+#define PAGESIZE        4096
+#define NULL            ((void *) 0)
+
+/* Most cpus a benchmark starts */
+#define BENCH_MAX_CPUS  2
+
+/* Device register of device dev on interrupt line line */
+#define BENCH_DEVREG(line, dev) ((volatile devreg_t *) DEV_REG_ADDR(line, dev))
+
+/* Processor state saved by the BIOS on exceptions taken by cpu */
+#define BENCH_EXC_STATE(cpu)    ((state_t *) (BIOS_DATA_PAGE_BASE + (cpu) * sizeof(state_t)))
+
+/* Device status and command codes */
+#define DEV_READY       1
+#define DEV_BUSY        3
+#define DEV_ACK         1
+#define DISK_SEEKCYL    2
+#define DISK_READBLK    3
+#define DISK_WRITEBLK   4
+#define TERM_TRANSMIT   2
+#define TERM_TRANSMITTED 5
+
+/* Memory at the top of RAM is taken by stacks: one page for the
+   exception handlers of each cpu, then one for the code each secondary
+   cpu runs; scratch buffers go right below */
+extern unsigned int benchHandlerStack(unsigned int cpu);
+extern unsigned int benchProcessStack(unsigned int cpu);
+extern unsigned int benchScratch(unsigned int size);
+
+/* Interrupts off, all interrupt lines masked, the timers loaded so
+   that they do not go off while a benchmark runs */
+extern void benchInit(void);
+
+/* Set the pass up vector of cpu; a NULL handler panics */
+extern void benchSetHandlers(unsigned int cpu, void (*tlbRefill)(void), void (*exception)(void));
+
+/* Handler for exceptions a benchmark does not expect */
+extern void benchUnexpected(void);
+
+/* Write command to a device register, wait (with interrupts off) for
+   the operation to complete and acknowledge it; returns the completion
+   status code */
+extern unsigned int benchDevCommand(volatile unsigned int *command, volatile unsigned int *status,
+                                    unsigned int value);
+
+/* Print a string on terminal 0 */
+extern void benchPrint(const char *s);
+
+/* Mark the start of the measured workload */
+extern void benchStart(void);
+
+/* Report the cycles and instructions run since benchStart() on
+   terminal 0, as "<name>: <cycles> cycles, <instructions> instructions",
+   and power the machine off; it does not return */
+extern void benchDone(const char *name);
+
+#endif /* !defined(UMPS_BENCH_H) */
@@ -0,0 +1,86 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * Disk streaming benchmark: writes every sector of disk 0 in order,
+ * then reads them all back and checks them, one DMA transfer per
+ * sector and one seek per cylinder. Run time is dominated by the disk
+ * model (seeks, rotation, read-ahead) and by idle cycles skipped while
+ * the cpu waits for completions.
+ *
+ ****************************************************************************/
+
+#include "bench.h"
+
+#define PASSES          2
+
+HIDDEN unsigned int sectorTag(unsigned int cyl, unsigned int head, unsigned int sect)
+{
+	return (cyl << 16) | (head << 8) | sect;
+}
+
+HIDDEN void diskCommand(volatile devreg_t *disk, unsigned int value)
+{
+	if (benchDevCommand(&disk->dtp.command, &disk->dtp.status, value) != DEV_READY)
+		PANIC();
+}
+
+int main(void)
+{
+	volatile devreg_t *disk = BENCH_DEVREG(IL_DISK, 0);
+	unsigned int *buf = (unsigned int *) benchScratch(PAGESIZE);
+	unsigned int cyls, heads, sects;
+	unsigned int pass, cyl, head, sect, tag;
+
+	benchInit();
+	if ((disk->dtp.status & 0xFF) != DEV_READY)
+		PANIC();
+
+	cyls = disk->dtp.data1 >> 16;
+	heads = (disk->dtp.data1 >> 8) & 0xFF;
+	sects = disk->dtp.data1 & 0xFF;
+
+	benchStart();
+
+	for (pass = 0; pass < PASSES; pass++) {
+		for (cyl = 0; cyl < cyls; cyl++) {
+			diskCommand(disk, (cyl << 8) | DISK_SEEKCYL);
+			for (head = 0; head < heads; head++) {
+				for (sect = 0; sect < sects; sect++) {
+					tag = sectorTag(cyl, head, sect);
+					disk->dtp.data0 = (unsigned int) buf;
+					if (pass == 0) {
+						buf[0] = tag;
+						buf[PAGESIZE / sizeof(unsigned int) - 1] = ~tag;
+						diskCommand(disk, (head << 16) | (sect << 8) | DISK_WRITEBLK);
+					} else {
+						diskCommand(disk, (head << 16) | (sect << 8) | DISK_READBLK);
+						if (buf[0] != tag || buf[PAGESIZE / sizeof(unsigned int) - 1] != ~tag)
+							PANIC();
+					}
+				}
+			}
+		}
+	}
+
+	benchDone("disk");
+	return 0;
+}
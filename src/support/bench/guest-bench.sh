@@ -0,0 +1,145 @@
+#!/bin/sh
+#
+# uMPS - A general purpose computer system simulator
+#
+# Copyright (C) 2026 The uMPS Authors
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# Runs the guest benchmark kernels headless with umps3-run and reports,
+# for each of them, the machine cycles the run took and how fast the
+# host simulated it (MIPS, best of several runs). Results are compared
+# with a baselines file: more guest cycles, or fewer host MIPS, than
+# the baseline by more than a threshold is a regression, and makes the
+# script exit with a failure status. With -u the baselines file is
+# rewritten from this run instead.
+#
+# The guest-bench build target runs this script on the kernels built
+# in this directory, against baselines.txt here; record that file with
+# -u on the reference host first.
+
+RUN=umps3-run
+BASELINES=
+UPDATE=
+FILTER=
+THRESHOLD=10
+CYCLES_THRESHOLD=0
+REPEAT=3
+MAX_CYCLES=2000000000
+
+usage() {
+	echo "usage: $0 [-r <umps3-run>] [-b <baselines>] [-u] [-t <percent>] [-g <percent>]" >&2
+	echo "       [-n <runs>] [-f <filter>] <benchdir>" >&2
+	echo >&2
+	echo "-r  umps3-run program to use (default: from PATH)" >&2
+	echo "-b  compare results with <baselines>" >&2
+	echo "-u  write the results to <baselines> instead" >&2
+	echo "-t  host MIPS regression threshold (default: $THRESHOLD%)" >&2
+	echo "-g  guest cycles regression threshold (default: $CYCLES_THRESHOLD%)" >&2
+	echo "-n  runs of each benchmark; the fastest counts (default: $REPEAT)" >&2
+	echo "-f  run only benchmarks whose name contains <filter>" >&2
+	exit 1
+}
+
+while getopts r:b:ut:g:n:f: opt; do
+	case $opt in
+	r) RUN=$OPTARG ;;
+	b) BASELINES=$OPTARG ;;
+	u) UPDATE=1 ;;
+	t) THRESHOLD=$OPTARG ;;
+	g) CYCLES_THRESHOLD=$OPTARG ;;
+	n) REPEAT=$OPTARG ;;
+	f) FILTER=$OPTARG ;;
+	*) usage ;;
+	esac
+done
+shift $((OPTIND - 1))
+[ $# -eq 1 ] || usage
+[ -z "$UPDATE" ] || [ -n "$BASELINES" ] || usage
+if [ -z "$UPDATE" ] && [ -n "$BASELINES" ] && [ ! -f "$BASELINES" ]; then
+	echo "$0: $BASELINES: no such baselines file (record it with -u)" >&2
+	exit 1
+fi
+DIR=$1
+
+RESULTS=$(mktemp) || exit 1
+trap 'rm -f "$RESULTS"' EXIT
+
+status=0
+for config in "$DIR"/bench-*.json; do
+	[ -f "$config" ] || { echo "$0: no benchmarks in $DIR" >&2; exit 1; }
+	name=${config##*/bench-}
+	name=${name%.json}
+	case $name in
+	*"$FILTER"*) ;;
+	*) continue ;;
+	esac
+
+	cycles=
+	mips=
+	i=0
+	while [ $i -lt "$REPEAT" ]; do
+		if ! out=$("$RUN" -c $MAX_CYCLES -p "$config"); then
+			echo "$0: $name failed" >&2
+			status=1
+			continue 2
+		fi
+		c=$(echo "$out" | sed -n 's/^Machine cycles: //p')
+		m=$(echo "$out" | sed -n 's/^Host MIPS: //p')
+		# Guest cycles do not depend on the host: any difference
+		# between runs is a simulator bug
+		if [ -n "$cycles" ] && [ "$c" != "$cycles" ]; then
+			echo "$0: $name ran $cycles cycles, then $c" >&2
+			status=1
+		fi
+		cycles=$c
+		mips=$(awk -v a="$m" -v b="${mips:-0}" 'BEGIN { print (a > b) ? a : b }')
+		i=$((i + 1))
+	done
+	echo "$name $cycles $mips" >> "$RESULTS"
+done
+
+if [ -n "$UPDATE" ]; then
+	{
+		echo "# benchmark guest-cycles host-MIPS"
+		cat "$RESULTS"
+	} > "$BASELINES" || exit 1
+	cat "$RESULTS"
+	exit $status
+fi
+
+[ -n "$BASELINES" ] || BASELINES=/dev/null
+
+awk -v t="$THRESHOLD" -v g="$CYCLES_THRESHOLD" '
+	function change(now, base) {
+		return base > 0 ? sprintf("%+.1f%%", (now - base) * 100 / base) : "-"
+	}
+	FILENAME == ARGV[1] {
+		if ($1 !~ /^#/) {
+			baseCycles[$1] = $2
+			baseMips[$1] = $3
+		}
+		next
+	}
+	FNR == 1 {
+		printf "%-10s %14s %14s %8s %10s %10s %8s\n",
+		       "Benchmark", "Cycles", "Baseline", "Change", "MIPS", "Baseline", "Change"
+	}
+	{
+		bc = ($1 in baseCycles) ? baseCycles[$1] : 0
+		bm = ($1 in baseMips) ? baseMips[$1] : 0
+		mark = ""
+		if ((bc > 0 && $2 > bc * (1 + g / 100)) || (bm > 0 && $3 < bm * (1 - t / 100))) {
+			mark = "  REGRESSION"
+			regressions++
+		}
+		printf "%-10s %14s %14s %8s %10.2f %10s %8s%s\n", $1, $2, (bc > 0 ? bc : "-"),
+		       change($2, bc), $3, (bm > 0 ? sprintf("%.2f", bm) : "-"), change($3, bm), mark
+	}
+	END { exit regressions > 0 }
+' "$BASELINES" "$RESULTS" || status=1
+
+exit $status
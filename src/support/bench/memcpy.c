@@ -0,0 +1,84 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * memcpy/memset benchmark: fills and copies a buffer over and over,
+ * a word and a byte at a time, stressing loads, stores and the memory
+ * access path of the processor.
+ *
+ ****************************************************************************/
+
+#include "bench.h"
+
+#define BUFSIZE         (32 * 1024)
+#define ROUNDS          16
+
+HIDDEN void wordSet(unsigned int *dst, unsigned int value, unsigned int n)
+{
+	unsigned int *end = dst + n / sizeof(unsigned int);
+
+	while (dst < end)
+		*dst++ = value;
+}
+
+HIDDEN void wordCopy(unsigned int *dst, const unsigned int *src, unsigned int n)
+{
+	unsigned int *end = dst + n / sizeof(unsigned int);
+
+	while (dst < end)
+		*dst++ = *src++;
+}
+
+HIDDEN void byteSet(unsigned char *dst, unsigned char value, unsigned int n)
+{
+	while (n-- > 0)
+		*dst++ = value;
+}
+
+HIDDEN void byteCopy(unsigned char *dst, const unsigned char *src, unsigned int n)
+{
+	while (n-- > 0)
+		*dst++ = *src++;
+}
+
+int main(void)
+{
+	unsigned int *src = (unsigned int *) benchScratch(2 * BUFSIZE);
+	unsigned int *dst = src + BUFSIZE / sizeof(unsigned int);
+	unsigned int i;
+
+	benchInit();
+	benchStart();
+
+	for (i = 0; i < ROUNDS; i++) {
+		wordSet(src, i, BUFSIZE);
+		wordCopy(dst, src, BUFSIZE);
+		byteSet((unsigned char *) src, (unsigned char) ~i, BUFSIZE);
+		byteCopy((unsigned char *) dst, (unsigned char *) src, BUFSIZE);
+	}
+
+	/* The last copy must have gone through */
+	if (dst[BUFSIZE / sizeof(unsigned int) - 1] != src[BUFSIZE / sizeof(unsigned int) - 1])
+		PANIC();
+
+	benchDone("memcpy");
+	return 0;
+}
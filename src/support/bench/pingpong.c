@@ -0,0 +1,96 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * IPI ping-pong benchmark: two cpus bounce an inter-processor
+ * interrupt back and forth. Both sit in WAIT between messages, so
+ * each round trip takes two interrupts, each with a full processor
+ * state save by the BIOS and a reload with LDST: the cost of a
+ * context switch driven by another cpu.
+ *
+ ****************************************************************************/
+
+#include "bench.h"
+
+#define ROUND_TRIPS     5000
+#define MSG_PING        1
+
+/* IPIs taken by each cpu */
+HIDDEN volatile unsigned int received[BENCH_MAX_CPUS];
+
+/* Processor state cpu 1 starts from */
+HIDDEN state_t startState;
+
+HIDDEN void sendIPI(unsigned int cpu, unsigned int msg)
+{
+	*((volatile unsigned int *) CPUCTL_OUTBOX) =
+		(msg << CPUCTL_OUTBOX_MSG_BIT) | (1U << (CPUCTL_OUTBOX_RECIP_BIT + cpu));
+}
+
+HIDDEN void idle(void)
+{
+	for (;;)
+		WAIT();
+}
+
+HIDDEN void ipiHandler(void)
+{
+	unsigned int cpu = getPRID();
+	state_t *s = BENCH_EXC_STATE(cpu);
+	volatile unsigned int *inbox = (volatile unsigned int *) CPUCTL_INBOX;
+
+	if (CAUSE_GET_EXCCODE(s->cause) != EXC_INT || !(s->cause & CAUSE_IP(IL_IPI)) ||
+	    CPUCTL_INBOX_GET_MSG(*inbox) != MSG_PING)
+		PANIC();
+	*inbox = 0;
+
+	/* The last pong ends the run here: the cpu would otherwise go back
+	   to a WAIT no IPI is coming to wake up */
+	if (++received[cpu] == ROUND_TRIPS && cpu == 0)
+		benchDone("pingpong");
+
+	sendIPI(1 - cpu, MSG_PING);
+	LDST(s);
+}
+
+int main(void)
+{
+	unsigned int status;
+
+	benchInit();
+	benchSetHandlers(0, NULL, ipiHandler);
+	benchSetHandlers(1, NULL, ipiHandler);
+
+	/* Interrupts get enabled when the state is loaded */
+	startState.status = STATUS_IEp | STATUS_IM(IL_IPI);
+	startState.pc_epc = (unsigned int) idle;
+	startState.reg_t9 = (unsigned int) idle;
+	startState.reg_sp = benchProcessStack(1);
+	INITCPU(1, &startState);
+
+	benchStart();
+	status = getSTATUS() & ~STATUS_IM_MASK;
+	setSTATUS(status | STATUS_IM(IL_IPI) | STATUS_IEc);
+	sendIPI(1, MSG_PING);
+	idle();
+
+	return 0;
+}
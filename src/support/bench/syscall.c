@@ -0,0 +1,61 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * Syscall storm benchmark: issues system calls back to back, each one
+ * going through the BIOS to a handler which saves nothing more than
+ * the BIOS does, computes a result and loads the caller state back.
+ *
+ ****************************************************************************/
+
+#include "bench.h"
+
+#define SYSCALLS        100000
+#define SYS_INCREMENT   1
+
+HIDDEN void syscallHandler(void)
+{
+	state_t *s = BENCH_EXC_STATE(0);
+
+	if (CAUSE_GET_EXCCODE(s->cause) != EXC_SYS || s->reg_a0 != SYS_INCREMENT)
+		PANIC();
+
+	s->reg_v0 = s->reg_a1 + 1;
+	s->pc_epc += sizeof(unsigned int);
+	LDST(s);
+}
+
+int main(void)
+{
+	unsigned int i;
+
+	benchInit();
+	benchSetHandlers(0, NULL, syscallHandler);
+	benchStart();
+
+	for (i = 0; i < SYSCALLS; i++) {
+		if (SYSCALL(SYS_INCREMENT, i, 0, 0) != i + 1)
+			PANIC();
+	}
+
+	benchDone("syscall");
+	return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * Terminal flood benchmark: transmits a stream of characters on
+ * terminal 1 as fast as the device takes them, one interrupt per
+ * character, exercising device command decoding, completion events
+ * and output buffering to the terminal file.
+ *
+ ****************************************************************************/
+
+#include "bench.h"
+
+#define CHARS           50000
+#define BYTELEN         8
+
+HIDDEN const char text[] = "The quick brown fox jumps over the lazy dog\n";
+
+int main(void)
+{
+	volatile devreg_t *term = BENCH_DEVREG(IL_TERMINAL, 1);
+	unsigned int i, c;
+
+	benchInit();
+	benchStart();
+
+	for (i = 0; i < CHARS; i++) {
+		c = (unsigned char) text[i % (sizeof(text) - 1)];
+		if (benchDevCommand(&term->term.transm_command, &term->term.transm_status,
+		                    (c << BYTELEN) | TERM_TRANSMIT) != TERM_TRANSMITTED)
+			PANIC();
+	}
+
+	benchDone("term");
+	return 0;
+}
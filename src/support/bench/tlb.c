@@ -0,0 +1,78 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * TLB thrash benchmark: touches a mapped region several times larger
+ * than the TLB, so that nearly every access misses and goes through
+ * the BIOS to a refill handler which walks a (trivial) page table.
+ *
+ * Virtual pages are backed by a handful of physical frames: the
+ * contents do not matter, only the translations do.
+ *
+ ****************************************************************************/
+
+#include "bench.h"
+
+#define REGION_BASE     0x80000000
+#define REGION_PAGES    256
+#define FRAMES          8
+#define ROUNDS          100
+
+HIDDEN unsigned int frames;
+
+HIDDEN void refillHandler(void)
+{
+	state_t *s = BENCH_EXC_STATE(0);
+	unsigned int page = ((s->entry_hi & ~(PAGESIZE - 1)) - REGION_BASE) / PAGESIZE;
+	unsigned int frame = frames + (page % FRAMES) * PAGESIZE;
+
+	if (page >= REGION_PAGES)
+		PANIC();
+
+	setENTRYHI(s->entry_hi);
+	setENTRYLO((frame & ENTRYLO_PFN_MASK) | ENTRYLO_DIRTY | ENTRYLO_VALID);
+	TLBWR();
+	LDST(s);
+}
+
+int main(void)
+{
+	unsigned int round, page;
+	volatile unsigned int *word;
+
+	benchInit();
+	frames = benchScratch(FRAMES * PAGESIZE);
+	benchSetHandlers(0, refillHandler, NULL);
+	TLBCLR();
+	benchStart();
+
+	for (round = 0; round < ROUNDS; round++) {
+		for (page = 0; page < REGION_PAGES; page++) {
+			/* Wander inside pages too, so that frames see some use */
+			word = (volatile unsigned int *) (REGION_BASE + page * PAGESIZE
+			                                  + (round * sizeof(unsigned int)) % PAGESIZE);
+			*word += page;
+		}
+	}
+
+	benchDone("tlb");
+	return 0;
+}
@@ -87,6 +87,16 @@
 #define RAMSTART        0x20000000
 #define BIOSDATAPAGE    0x0FFFF000
 
+/* The BIOS data page holds the saved exception states of the first
+   BIOSDATACPUS cpus only; the other ones are in the extended data area */
+#define BIOSDATACPUS    16
+#define BIOSEXTDATA     0x0FFFC000
+#define BIOSSTATESIZE   140
+
+/* Exception state saved by the BIOS for a cpu */
+#define BIOSEXCSTATE(cpu)   ((cpu) < BIOSDATACPUS ? BIOSDATAPAGE + (cpu) * BIOSSTATESIZE \
+                                                  : BIOSEXTDATA + ((cpu) - BIOSDATACPUS) * BIOSSTATESIZE)
+
 /* Useful Operations */
 #define MIN(A,B)        ((A) < (B) ? A : B)
 #define MAX(A,B)        ((A) < (B) ? B : A)
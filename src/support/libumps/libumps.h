@@ -68,6 +68,25 @@ extern unsigned int getPRID(void);
 extern unsigned int getTIMER(void);
 
 
+/* These functions read the performance counters of the calling cpu
+ * (see CPUCTL_PERF_* in umps/arch.h): cycles, retired instructions,
+ * TLB refills, exceptions and interrupts taken, idle cycles. All of
+ * them wrap around at 2^32, so compute differences as unsigned
+ */
+
+extern unsigned int getPERFCYCLES(void);
+
+extern unsigned int getPERFINSTRS(void);
+
+extern unsigned int getPERFTLBREFILLS(void);
+
+extern unsigned int getPERFEXCEPTIONS(void);
+
+extern unsigned int getPERFINTERRUPTS(void);
+
+extern unsigned int getPERFIDLE(void);
+
+
 /* Only some of CP0 register are R/W: handling requires care.
  * All functions return the value in register after write
  */
@@ -0,0 +1,705 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * This is a stand-alone program which times simulator hot paths on
+ * synthetic workloads: processor cycles on instruction mixes, address
+ * translation at several TLB sizes, system bus decoding, event queue
+ * insertion, stoppoint lookup and DMA transfers.
+ *
+ * Each benchmark is run for a while, in several samples; the best
+ * sample gives its time per operation. Results are written as JSON,
+ * and compared with a previous run (the baseline) if given one: any
+ * benchmark slower than the baseline by more than a threshold is a
+ * regression, and makes the program exit with a failure status.
+ *
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/bind/bind.hpp>
+#include <boost/function.hpp>
+
+#include "base/lang.h"
+#include "base/json.h"
+#include "umps/arch.h"
+#include "umps/const.h"
+#include "umps/types.h"
+#include "umps/error.h"
+#include "umps/processor_defs.h"
+#include "umps/blockdev_params.h"
+#include "umps/blockdev.h"
+#include "umps/event.h"
+#include "umps/machine_config.h"
+#include "umps/machine.h"
+#include "umps/processor.h"
+#include "umps/stoppoint.h"
+#include "umps/systembus.h"
+
+// Samples taken of each benchmark
+HIDDEN const unsigned int kSamples = 5;
+
+// Physical layout of benchmark code and data
+HIDDEN const Word kCodeAddr = RAM_BASE + 0x4000;
+HIDDEN const Word kDataAddr = RAM_BASE + 0x8000;
+
+// Virtual addresses the code and data pages are mapped to, and where
+// the other (unused) TLB entries point
+HIDDEN const Word kMappedCode = KUSEG_BASE;
+HIDDEN const Word kMappedData = KUSEG_BASE + 0x10000;
+HIDDEN const Word kMappedSpare = KUSEG_BASE + 0x100000;
+
+// Instructions in the body of benchmark loops
+HIDDEN const unsigned int kLoopLength = 240;
+
+// Scratch directory holding the machine configuration and ROM
+HIDDEN std::string scratchDir;
+
+// A benchmark, ready to run: each Run() call performs ops operations
+// of the code under test
+class Benchmark {
+public:
+	virtual ~Benchmark() {}
+	virtual void Run(uint64_t ops) = 0;
+};
+
+struct BenchmarkSpec {
+	std::string name;
+	boost::function<Benchmark* ()> create;
+};
+
+HIDDEN void showHelp(const char * prgName);
+HIDDEN bool makeScratchDir();
+HIDDEN void removeScratchDir();
+HIDDEN std::vector<BenchmarkSpec> listBenchmarks();
+HIDDEN uint64_t measure(Benchmark * bench, unsigned int minTime, uint64_t * opsRun);
+HIDDEN JsonObject * loadBaseline(const char * prgName, const char * fileName);
+
+// Guest or simulator fatal errors end the run
+void Panic(const char* message)
+{
+	fprintf(stderr, "PANIC: %s\n", message);
+	exit(EXIT_FAILURE);
+}
+
+// This function scans the line arguments, then runs the benchmarks
+// whose name contains the filter (all of them by default) and writes
+// their results. Returns an EXIT_SUCCESS/FAILURE code: regressions
+// are failures
+int main(int argc, char * argv[])
+{
+	const char * outName = NULL;
+	const char * baselineName = NULL;
+	const char * filter = "";
+	unsigned int threshold = 10;
+	unsigned int minTime = 500;
+	int ret = EXIT_SUCCESS;
+	int i;
+
+	// scan line arguments
+	for (i = 1; i < argc && ret != EXIT_FAILURE; i++)
+	{
+		if (SAMESTRING("-o", argv[i]) && i < argc - 1)
+			outName = argv[++i];
+		else
+		if (SAMESTRING("-b", argv[i]) && i < argc - 1)
+			baselineName = argv[++i];
+		else
+		if (SAMESTRING("-t", argv[i]) && i < argc - 1)
+			threshold = strtoul(argv[++i], NULL, 0);
+		else
+		if (SAMESTRING("-m", argv[i]) && i < argc - 1)
+			minTime = std::max(1UL, strtoul(argv[++i], NULL, 0));
+		else
+		if (SAMESTRING("-f", argv[i]) && i < argc - 1)
+			filter = argv[++i];
+		else
+			// unrecognized option
+			ret = EXIT_FAILURE;
+	}
+
+	if (ret == EXIT_FAILURE) {
+		showHelp(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	scoped_ptr<JsonObject> baseline;
+	const JsonObject* oldResults = NULL;
+	if (baselineName != NULL) {
+		baseline.reset(loadBaseline(argv[0], baselineName));
+		if (!baseline)
+			return EXIT_FAILURE;
+		oldResults = baseline->Get("benchmarks")->AsObject();
+	}
+
+	if (makeScratchDir()) {
+		fprintf(stderr, "%s : Error : cannot create a scratch directory\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	JsonObject root;
+	JsonObject* results = new JsonObject;
+	root.Set("min-time-ms", (int) minTime);
+	root.Set("benchmarks", results);
+
+	for (const BenchmarkSpec& spec : listBenchmarks()) {
+		if (spec.name.find(filter) == std::string::npos)
+			continue;
+
+		uint64_t ops;
+		uint64_t ps;
+		try {
+			scoped_ptr<Benchmark> bench(spec.create());
+			ps = measure(bench.get(), minTime, &ops);
+		} catch (const Error& e) {
+			fprintf(stderr, "%s : %s : %s\n", argv[0], spec.name.c_str(), e.what());
+			ret = EXIT_FAILURE;
+			continue;
+		}
+
+		JsonObject* result = new JsonObject;
+		result->Set("ps-per-op", (int) std::min(ps, (uint64_t) INT_MAX));
+		result->Set("ops", (int) std::min(ops, (uint64_t) INT_MAX));
+		results->Set(spec.name, result);
+		fprintf(stderr, "%-28s %12.3f ns/op", spec.name.c_str(), ps / 1000.0);
+
+		// Compare with the baseline, if it has this benchmark
+		const JsonObject* old = NULL;
+		if (oldResults != NULL && oldResults->HasMember(spec.name))
+			old = oldResults->Get(spec.name)->AsObject();
+		if (old != NULL && old->HasMember("ps-per-op") && old->Get("ps-per-op")->AsNumber() > 0) {
+			int oldPs = old->Get("ps-per-op")->AsNumber();
+			double change = 100.0 * ((double) ps - oldPs) / oldPs;
+			bool regression = change > threshold;
+			char buf[32];
+			snprintf(buf, sizeof(buf), "%+.1f%%", change);
+			result->Set("baseline-ps-per-op", oldPs);
+			result->Set("change", buf);
+			result->Set("regression", regression);
+			fprintf(stderr, " %8s%s", buf, regression ? "  REGRESSION" : "");
+			if (regression)
+				ret = EXIT_FAILURE;
+		}
+		fprintf(stderr, "\n");
+	}
+
+	removeScratchDir();
+
+	std::string buf;
+	root.Serialize(buf, true);
+	buf += "\n";
+	if (outName == NULL) {
+		fputs(buf.c_str(), stdout);
+	} else {
+		std::ofstream file(outName, std::ios_base::trunc | std::ios_base::out);
+		if (file.fail() || !(file << buf)) {
+			fprintf(stderr, "%s : Error writing %s\n", argv[0], outName);
+			return EXIT_FAILURE;
+		}
+	}
+
+	return ret;
+}
+
+// This function prints a warning/help message on standard error
+HIDDEN void showHelp(const char * prgName)
+{
+	fprintf(stderr, "%s syntax : %s [-o <file>] [-b <baseline>] [-t <percent>] [-m <ms>] [-f <filter>]\n\n", prgName, prgName);
+	fprintf(stderr, "where:\n\n-o\twrite results to <file> instead of standard output\n");
+	fprintf(stderr, "-b\tcompare results with <baseline>, the output of a previous run\n");
+	fprintf(stderr, "-t\tslowdown over the baseline making a regression (default: 10%%)\n");
+	fprintf(stderr, "-m\ttime to run each benchmark for (default: 500 ms)\n");
+	fprintf(stderr, "-f\trun only benchmarks whose name contains <filter>\n\n");
+}
+
+// This function loads a baseline file, checking it holds benchmark
+// results; returns NULL (after printing why) on errors
+HIDDEN JsonObject * loadBaseline(const char * prgName, const char * fileName)
+{
+	std::ifstream inputStream(fileName);
+	if (inputStream.fail()) {
+		fprintf(stderr, "%s : Error opening file %s\n", prgName, fileName);
+		return NULL;
+	}
+
+	std::unique_ptr<JsonNode> root;
+	try {
+		JsonParser parser;
+		root.reset(parser.Parse(inputStream));
+		if (root->Holds(JSON_OBJECT) && root->AsObject()->HasMember("benchmarks") &&
+		    root->AsObject()->Get("benchmarks")->Holds(JSON_OBJECT))
+			return root.release()->AsObject();
+	} catch (JsonParser::SyntaxError& e) {
+	}
+
+	fprintf(stderr, "%s : Error : %s is not a benchmark results file\n", prgName, fileName);
+	return NULL;
+}
+
+// This function runs a benchmark with more and more operations, until
+// a run takes a sample's share of minTime; further samples are then
+// taken with that many operations. Returns the best time per
+// operation, in picoseconds, and the operations run by a sample
+HIDDEN uint64_t measure(Benchmark * bench, unsigned int minTime, uint64_t * opsRun)
+{
+	typedef std::chrono::steady_clock Clock;
+	const double sampleTime = minTime / 1000.0 / kSamples;
+	uint64_t ops = 1;
+	double best, elapsed;
+
+	for (;;) {
+		Clock::time_point start = Clock::now();
+		bench->Run(ops);
+		elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		if (elapsed >= sampleTime)
+			break;
+		// Aim past the sample time, without growing too fast on
+		// timer noise
+		ops = (elapsed > 0) ? std::max(ops * 2, (uint64_t) (ops * 1.2 * sampleTime / elapsed)) : ops * 10;
+		ops = std::min(ops, (uint64_t) 1 << 40);
+	}
+
+	best = elapsed;
+	for (unsigned int i = 1; i < kSamples; i++) {
+		Clock::time_point start = Clock::now();
+		bench->Run(ops);
+		best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+	}
+
+	*opsRun = ops;
+	return (uint64_t) (best * 1e12 / ops);
+}
+
+// A cheap pseudo-random sequence, the same on every run
+class XorShift {
+public:
+	XorShift() : state(88172645) {}
+	Word Next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+private:
+	Word state;
+};
+
+//
+// Machine
+//
+
+// This function creates the scratch directory, with a ROM holding
+// nothing but a loop. Returns TRUE on errors
+HIDDEN bool makeScratchDir()
+{
+	char dirTemplate[] = "/tmp/umps-bench.XXXXXX";
+	if (mkdtemp(dirTemplate) == NULL)
+		return true;
+	scratchDir = dirTemplate;
+
+	// "b ." and its delay slot
+	const Word rom[] = {
+		BIOSFILEID, 2,
+		(BEQ << OPCODEOFFS) | (0xFFFF & IMMMASK), NOP
+	};
+	FILE* file = fopen((scratchDir + "/bench.rom.umps").c_str(), "w");
+	if (file == NULL)
+		return true;
+	bool error = fwrite(rom, sizeof(rom), 1, file) != 1;
+	return (fclose(file) != 0) || error;
+}
+
+HIDDEN void removeScratchDir()
+{
+	unlink((scratchDir + "/bench.rom.umps").c_str());
+	unlink((scratchDir + "/bench.json").c_str());
+	rmdir(scratchDir.c_str());
+}
+
+// A one-cpu machine, with no devices, to run benchmarks on
+class BenchMachine {
+public:
+	BenchMachine(Word tlbSize, Word tlbFloorAddress)
+	{
+		std::string rom = scratchDir + "/bench.rom.umps";
+		config.reset(MachineConfig::Create(scratchDir + "/bench.json"));
+		config->setDeviceEnabled(EXT_IL_INDEX(IL_TERMINAL), 0, false);
+		config->setLoadCoreEnabled(false);
+		config->setROM(ROM_TYPE_BOOT, rom);
+		config->setROM(ROM_TYPE_BIOS, rom);
+		config->setTLBSize(tlbSize);
+		config->setTLBFloorAddress(tlbFloorAddress);
+		machine.reset(new Machine(config.get(), &breakpoints, &suspects, &tracepoints));
+	}
+
+	Machine* get() {
+		return machine.get();
+	}
+	Processor* cpu() {
+		return machine->getProcessor(0);
+	}
+	SystemBus* bus() {
+		return machine->getBus();
+	}
+
+private:
+	scoped_ptr<MachineConfig> config;
+	StoppointSet breakpoints, suspects, tracepoints;
+	scoped_ptr<Machine> machine;
+};
+
+// This function maps the code and data pages at the end of the TLB,
+// all other entries pointing to spare pages
+HIDDEN void fillTLB(Processor * cpu, unsigned int tlbSize)
+{
+	const Word lo = (1UL << VBITPOS) | (1UL << DBITPOS) | (1UL << GBITPOS);
+
+	for (unsigned int i = 0; i < tlbSize - 2; i++)
+		cpu->setTLB(i, kMappedSpare + i * FRAMESIZE * WS, kDataAddr | lo);
+	cpu->setTLB(tlbSize - 2, kMappedCode, kCodeAddr | lo);
+	cpu->setTLB(tlbSize - 1, kMappedData, kDataAddr | lo);
+}
+
+//
+// Processor
+//
+
+HIDDEN Word regInstr(Word funct, Word rs, Word rt, Word rd, Word shamt = 0)
+{
+	return (rs << RSOFFSET) | (rt << RTOFFSET) | (rd << RDOFFSET) | (shamt << SHAMTOFFS) | funct;
+}
+
+HIDDEN Word immInstr(Word opcode, Word rs, Word rt, Word imm)
+{
+	return (opcode << OPCODEOFFS) | (rs << RSOFFSET) | (rt << RTOFFSET) | (imm & IMMMASK);
+}
+
+// Instruction mixes, as a pattern of ALU operations (a), loads and
+// stores (m) and branches (b), repeated along the loop body
+HIDDEN const char* const mixPattern[] = { "a", "m", "b", "aaaaammmbb" };
+enum Mix { MIX_ALU, MIX_MEMORY, MIX_BRANCH, MIX_MIXED };
+
+// This function writes the benchmark loop for a mix at kCodeAddr, and
+// returns its length in words; data accesses are relative to $16
+HIDDEN unsigned int writeLoop(Machine * machine, Mix mix, Word loopAddr)
+{
+	const Word alu[] = {
+		regInstr(SFN_ADDU, 8, 9, 8),
+		immInstr(ADDIU, 9, 9, 3),
+		regInstr(SFN_XOR, 8, 9, 10),
+		regInstr(SFN_SLL, 0, 10, 11, 2),
+		regInstr(SFN_SLT, 11, 8, 12),
+		regInstr(SFN_OR, 12, 10, 13)
+	};
+	const char* pattern = mixPattern[mix];
+	std::vector<Word> code;
+	unsigned int nAlu = 0, nMem = 0, nBranch = 0;
+
+	for (unsigned int i = 0; code.size() < kLoopLength; i++) {
+		switch (pattern[i % strlen(pattern)]) {
+		case 'a':
+			code.push_back(alu[nAlu++ % (sizeof(alu) / sizeof(alu[0]))]);
+			break;
+		case 'm':
+			if (nMem % 2 == 0)
+				code.push_back(immInstr(LW, 16, 14, (nMem * WS) % (FRAMESIZE * WS)));
+			else
+				code.push_back(immInstr(SW, 16, 9, (nMem * WS) % (FRAMESIZE * WS)));
+			nMem++;
+			break;
+		case 'b':
+			// Taken and not taken in turn; the delay slot is
+			// followed by an instruction a taken branch skips
+			code.push_back(immInstr(nBranch++ % 2 ? BNE : BEQ, 0, 0, 1));
+			code.push_back(immInstr(ADDIU, 15, 15, 1));
+			code.push_back(immInstr(ADDIU, 15, 15, 2));
+			break;
+		}
+	}
+	code.push_back((J << OPCODEOFFS) | ((loopAddr >> WORDSHIFT) & ~OPCODEMASK));
+	code.push_back(NOP);
+
+	for (unsigned int i = 0; i < code.size(); i++)
+		machine->WriteMemory(kCodeAddr + i * WS, code[i]);
+	return code.size();
+}
+
+// Processor::Cycle() on an instruction mix, running from unmapped
+// memory or (with a TLB) from mapped memory
+class CycleBenchmark : public Benchmark {
+public:
+	CycleBenchmark(Mix mix, Word tlbSize, bool mapped)
+		: machine(tlbSize, mapped ? KUSEG_BASE : MachineConfig::DEFAULT_TLB_FLOOR_ADDRESS)
+	{
+		Word loopAddr = mapped ? kMappedCode : kCodeAddr;
+		writeLoop(machine.get(), mix, loopAddr);
+		if (mapped)
+			fillTLB(machine.cpu(), tlbSize);
+		machine.cpu()->Reset(loopAddr, 0);
+		machine.cpu()->setGPR(16, mapped ? kMappedData : kDataAddr);
+	}
+
+	void Run(uint64_t ops) {
+		Processor* cpu = machine.cpu();
+		for (uint64_t i = 0; i < ops; i++)
+			cpu->Cycle();
+	}
+
+private:
+	BenchMachine machine;
+};
+
+// Address translation (the TLB lookup of mapVirtual()), through the
+// side-effect free Processor::TranslateAddress()
+class TranslateBenchmark : public Benchmark {
+public:
+	TranslateBenchmark(Word tlbSize)
+		: machine(tlbSize, KUSEG_BASE),
+		  tlbSize(tlbSize)
+	{
+		fillTLB(machine.cpu(), tlbSize);
+	}
+
+	void Run(uint64_t ops) {
+		Processor* cpu = machine.cpu();
+		Word paddr, sum = 0;
+		for (uint64_t i = 0; i < ops; i++) {
+			Word entry = i % tlbSize;
+			Word vaddr = (entry < tlbSize - 2) ? kMappedSpare + entry * FRAMESIZE * WS : kMappedData;
+			if (!cpu->TranslateAddress(vaddr + (i % FRAMESIZE) * WS, &paddr))
+				sum += paddr;
+		}
+		sink = sum;
+	}
+
+private:
+	BenchMachine machine;
+	const Word tlbSize;
+	volatile Word sink;
+};
+
+//
+// System bus
+//
+
+enum BusAccess { BUS_READ_RAM, BUS_WRITE_RAM, BUS_READ_ROM, BUS_READ_DEVREG, BUS_READ_BUSREG };
+
+// SystemBus::DataRead() and DataWrite() decoding, on each kind of
+// address space
+class BusBenchmark : public Benchmark {
+public:
+	BusBenchmark(BusAccess access)
+		: machine(MachineConfig::DEFAULT_TLB_SIZE, MachineConfig::DEFAULT_TLB_FLOOR_ADDRESS),
+		  access(access)
+	{
+	}
+
+	void Run(uint64_t ops) {
+		SystemBus* bus = machine.bus();
+		Processor* cpu = machine.cpu();
+		Word data, sum = 0;
+
+		for (uint64_t i = 0; i < ops; i++) {
+			switch (access) {
+			case BUS_READ_RAM:
+				bus->DataRead(kDataAddr + (i % FRAMESIZE) * WS, &data, cpu);
+				break;
+			case BUS_WRITE_RAM:
+				bus->DataWrite(kDataAddr + (i % FRAMESIZE) * WS, (Word) i, cpu);
+				data = 0;
+				break;
+			case BUS_READ_ROM:
+				bus->DataRead(KSEG0_BOOT_BASE + (i % 2) * WS, &data, cpu);
+				break;
+			case BUS_READ_DEVREG:
+				bus->DataRead(DEV_REG_START + (i % (DEV_REG_END - DEV_REG_START) / WS) * WS, &data, cpu);
+				break;
+			case BUS_READ_BUSREG:
+				bus->DataRead(BUS_REG_TOD_LO, &data, cpu);
+				break;
+			}
+			sum += data;
+		}
+		sink = sum;
+	}
+
+private:
+	BenchMachine machine;
+	const BusAccess access;
+	volatile Word sink;
+};
+
+// SystemBus::DMATransfer() of a block, from or to memory
+class DMABenchmark : public Benchmark {
+public:
+	DMABenchmark(bool toMemory)
+		: machine(MachineConfig::DEFAULT_TLB_SIZE, MachineConfig::DEFAULT_TLB_FLOOR_ADDRESS),
+		  toMemory(toMemory)
+	{
+		for (unsigned int i = 0; i < BLOCKSIZE; i++)
+			block.setWord(i, i);
+	}
+
+	void Run(uint64_t ops) {
+		for (uint64_t i = 0; i < ops; i++)
+			machine.bus()->DMATransfer(&block, kDataAddr, toMemory);
+	}
+
+private:
+	BenchMachine machine;
+	const bool toMemory;
+	Block block;
+};
+
+//
+// Event queue
+//
+
+// EventQueue::InsertQ() into a queue holding depth events, at random
+// delays; the head event is then removed, keeping the depth
+class EventQueueBenchmark : public Benchmark {
+public:
+	EventQueueBenchmark(unsigned int depth)
+		: tod(0)
+	{
+		for (unsigned int i = 0; i < depth; i++)
+			queue.InsertQ(tod, random.Next() % kMaxDelay + 1, Event::Callback());
+	}
+
+	void Run(uint64_t ops) {
+		for (uint64_t i = 0; i < ops; i++) {
+			queue.InsertQ(tod, random.Next() % kMaxDelay + 1, Event::Callback());
+			tod = queue.nextDeadline();
+			queue.RemoveHead();
+		}
+	}
+
+private:
+	static const Word kMaxDelay = 100000;
+
+	EventQueue queue;
+	XorShift random;
+	uint64_t tod;
+};
+
+//
+// Stoppoints
+//
+
+// StoppointSet::Probe() on a set of count breakpoints, one per
+// 16-word slot, probing random addresses over twice their span
+// (hits are a small fraction of probes)
+class StoppointBenchmark : public Benchmark {
+public:
+	StoppointBenchmark(unsigned int count)
+		: span(count * 16 * WS)
+	{
+		for (unsigned int i = 0; i < count; i++)
+			points.Add(AddressRange(MAXASID, RAM_BASE + i * 16 * WS, RAM_BASE + i * 16 * WS + WS - 1), AM_EXEC);
+	}
+
+	void Run(uint64_t ops) {
+		unsigned int hits = 0;
+		for (uint64_t i = 0; i < ops; i++) {
+			Word addr = RAM_BASE + ((random.Next() % (2 * span)) & ~(WS - 1));
+			if (points.Probe(MAXASID, addr, AM_EXEC, NULL) != NULL)
+				hits++;
+		}
+		sink = hits;
+	}
+
+private:
+	StoppointSet points;
+	const Word span;
+	XorShift random;
+	volatile unsigned int sink;
+};
+
+template<typename T, typename A>
+HIDDEN Benchmark * create(A arg)
+{
+	return new T(arg);
+}
+
+HIDDEN Benchmark * createCycle(Mix mix, Word tlbSize, bool mapped)
+{
+	return new CycleBenchmark(mix, tlbSize, mapped);
+}
+
+// This function lists all benchmarks
+HIDDEN std::vector<BenchmarkSpec> listBenchmarks()
+{
+	static const char* const mixName[] = { "alu", "memory", "branch", "mixed" };
+	static const Word tlbSizes[] = { 4, 16, 64 };
+	static const char* const busName[] = { "read-ram", "write-ram", "read-rom", "read-devreg", "read-busreg" };
+	std::vector<BenchmarkSpec> specs;
+	BenchmarkSpec spec;
+
+	for (unsigned int mix = MIX_ALU; mix <= MIX_MIXED; mix++) {
+		spec.name = std::string("cycle/") + mixName[mix];
+		spec.create = boost::bind(createCycle, (Mix) mix, MachineConfig::DEFAULT_TLB_SIZE, false);
+		specs.push_back(spec);
+	}
+	for (Word size : tlbSizes) {
+		spec.name = "tlb/mapped-cycle-" + std::to_string(size);
+		spec.create = boost::bind(createCycle, MIX_MIXED, size, true);
+		specs.push_back(spec);
+	}
+	for (Word size : tlbSizes) {
+		spec.name = "tlb/translate-" + std::to_string(size);
+		spec.create = boost::bind(create<TranslateBenchmark, Word>, size);
+		specs.push_back(spec);
+	}
+	for (unsigned int access = BUS_READ_RAM; access <= BUS_READ_BUSREG; access++) {
+		spec.name = std::string("bus/") + busName[access];
+		spec.create = boost::bind(create<BusBenchmark, BusAccess>, (BusAccess) access);
+		specs.push_back(spec);
+	}
+	for (unsigned int depth : { 16, 1024 }) {
+		spec.name = "eventq/insert-" + std::to_string(depth);
+		spec.create = boost::bind(create<EventQueueBenchmark, unsigned int>, depth);
+		specs.push_back(spec);
+	}
+	for (unsigned int count : { 16, 256, 4096 }) {
+		spec.name = "stoppoint/probe-" + std::to_string(count);
+		spec.create = boost::bind(create<StoppointBenchmark, unsigned int>, count);
+		specs.push_back(spec);
+	}
+	spec.name = "dma/block-to-memory";
+	spec.create = boost::bind(create<DMABenchmark, bool>, true);
+	specs.push_back(spec);
+	spec.name = "dma/block-from-memory";
+	spec.create = boost::bind(create<DMABenchmark, bool>, false);
+	specs.push_back(spec);
+
+	return specs;
+}
@@ -29,6 +29,7 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <fcntl.h>
 
 #include <umps/const.h>
 
@@ -37,6 +38,8 @@
 #include "umps/utility.h"
 #include "umps/blockdev.h"
 
+HIDDEN bool punchBlock(FILE * blkFile, SWord offset, const Word * buf);
+
 
 // This method returns an empty (unitialized) 4096 byte Block
 Block::Block()
@@ -71,6 +74,10 @@ bool Block::WriteBlock(FILE * blkFile, SWord offset)
 		// already at EOF
 		return(true);
 	else
+	if (punchBlock(blkFile, offset, blkBuf))
+		// empty block turned into a hole: nothing to write
+		return(false);
+	else
 	if (fwrite((void *)blkBuf, WORDLEN, BLOCKSIZE, blkFile) != BLOCKSIZE)
 		// some error occurred
 		return(true);
@@ -81,6 +88,27 @@ bool Block::WriteBlock(FILE * blkFile, SWord offset)
 }
 
 
+// This method fills num consecutive Blocks of array blks with file
+// contents starting at "offset" bytes from file start, using a single
+// file access. Returns TRUE if read does not succeed, FALSE otherwise
+bool Block::ReadBlocks(Block * blks, unsigned int num, FILE * blkFile, SWord offset)
+{
+	// a Block array is a plain array of words: it may be filled at once
+	static_assert(sizeof(Block) == BLOCKSIZE * WORDLEN, "Block must not be padded");
+
+	if (fseek(blkFile, offset, SEEK_SET) == EOF)
+		// already at EOF
+		return(true);
+	else
+	if (fread((void *)blks, sizeof(Block), num, blkFile) != num)
+		// file too short
+		return(true);
+	else
+		// all OK
+		return(false);
+}
+
+
 // This method returns the Word contained in the Block at ofs (Word items)
 // offset, range [0..BLOCKSIZE - 1]. Warning: in-bounds checking is leaved
 // to caller
@@ -214,3 +242,25 @@ unsigned int FlashParams::getWTime(void)
 {
 	return(parms[WTIME]);
 }
+
+
+// This function releases the file space backing an all-zero block, so that
+// image files created sparse by umps3-mkdev stay sparse while in use.
+// Returns TRUE if the block is empty and now reads back as a hole, FALSE if
+// it has to be written as usual (non-empty block, or no hole punching
+// support on host file system)
+HIDDEN bool punchBlock(FILE * blkFile, SWord offset, const Word * buf)
+{
+#ifdef FALLOC_FL_PUNCH_HOLE
+	unsigned int i;
+
+	for (i = 0; i < BLOCKSIZE; i++)
+		if (buf[i] != 0UL)
+			return(false);
+
+	return(fallocate(fileno(blkFile), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+	                 offset, BLOCKSIZE * WORDLEN) == 0);
+#else
+	return(false);
+#endif
+}
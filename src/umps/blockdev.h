@@ -44,6 +44,11 @@ public:
 // write does not succeed, FALSE otherwise
 	bool WriteBlock(FILE * blkFile, SWord offset);
 
+// This method fills num consecutive Blocks of array blks with file
+// contents starting at "offset" bytes from file start, using a single
+// file access. Returns TRUE if read does not succeed, FALSE otherwise
+	static bool ReadBlocks(Block * blks, unsigned int num, FILE * blkFile, SWord offset);
+
 // This method returns the Word contained in the Block at ofs (Word
 // items) offset, range [0..BLOCKSIZE - 1]. Warning: in-bounds
 // checking is leaved to caller
@@ -0,0 +1,226 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/cache_model.h"
+
+#include <string.h>
+
+#include "umps/arch.h"
+#include "umps/processor.h"
+
+Cache::Cache(unsigned int kb, unsigned int ways, unsigned int lineSize)
+	: lineShift(0),
+	  ways(ways),
+	  clock(0)
+{
+	while ((1U << lineShift) < lineSize)
+		lineShift++;
+
+	// A cache smaller than a set still gets one
+	sets = (kb * 1024) / (lineSize * ways);
+	if (sets == 0)
+		sets = 1;
+
+	tags.reset(new Word[sets * ways]);
+	stamps.reset(new uint64_t[sets * ways]);
+	Flush();
+}
+
+bool Cache::Lookup(Word addr)
+{
+	Word tag = (addr >> lineShift) + 1;
+	unsigned int base = ((addr >> lineShift) % sets) * ways;
+	unsigned int victim = base;
+
+	clock++;
+	for (unsigned int i = base; i < base + ways; i++) {
+		if (tags[i] == tag) {
+			stamps[i] = clock;
+			return true;
+		}
+		if (stamps[i] < stamps[victim])
+			victim = i;
+	}
+
+	tags[victim] = tag;
+	stamps[victim] = clock;
+	return false;
+}
+
+bool Cache::Invalidate(Word addr)
+{
+	Word tag = (addr >> lineShift) + 1;
+	unsigned int base = ((addr >> lineShift) % sets) * ways;
+
+	for (unsigned int i = base; i < base + ways; i++) {
+		if (tags[i] == tag) {
+			tags[i] = 0;
+			stamps[i] = 0;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Cache::Flush()
+{
+	memset(tags.get(), 0, sizeof(Word) * sets * ways);
+	memset(stamps.get(), 0, sizeof(uint64_t) * sets * ways);
+	clock = 0;
+}
+
+CacheModel::CacheModel(const MachineConfig* config)
+	: numCpus(config->getNumProcessors()),
+	  l2Latency(config->getL2Latency()),
+	  memoryLatency(config->getMemoryLatency()),
+	  stall(config->isCacheStallEnabled()),
+	  l1(new scoped_ptr<Cache>[2 * config->getNumProcessors()]),
+	  stats(new CacheStats[config->getNumProcessors() * N_CACHE_LEVELS])
+{
+	for (unsigned int i = 0; i < 2 * numCpus; i++) {
+		CacheLevel level = (i % 2) ? CACHE_L1D : CACHE_L1I;
+		if (config->getCacheSize(level) > 0)
+			l1[i].reset(new Cache(config->getCacheSize(level),
+			                      config->getCacheWays(level),
+			                      config->getCacheLineSize(level)));
+	}
+	if (config->getCacheSize(CACHE_L2) > 0)
+		l2.reset(new Cache(config->getCacheSize(CACHE_L2),
+		                   config->getCacheWays(CACHE_L2),
+		                   config->getCacheLineSize(CACHE_L2)));
+
+	Reset();
+}
+
+CacheModel::~CacheModel()
+{
+}
+
+bool CacheModel::hasLevel(CacheLevel level) const
+{
+	return getCache(0, level) != NULL;
+}
+
+Cache* CacheModel::getCache(Word cpu, CacheLevel level) const
+{
+	if (level == CACHE_L2)
+		return l2.get();
+	return l1[2 * cpu + (level == CACHE_L1D)].get();
+}
+
+// Look addr up in a level of the hierarchy, and below it on a miss;
+// returns the latency of the access
+Word CacheModel::access(Word cpu, CacheLevel level, Word addr)
+{
+	Cache* cache = getCache(cpu, level);
+
+	if (cache != NULL) {
+		CacheStats& s = stats[cpu * N_CACHE_LEVELS + level];
+		if (cache->Lookup(addr)) {
+			s.hits++;
+			return level == CACHE_L2 ? l2Latency : 0;
+		}
+		s.misses++;
+	}
+
+	if (level != CACHE_L2)
+		return access(cpu, CACHE_L2, addr);
+	return (cache != NULL ? l2Latency : 0) + memoryLatency;
+}
+
+void CacheModel::invalidate(Word cpu, CacheLevel level, Word addr)
+{
+	Cache* cache = getCache(cpu, level);
+	if (cache != NULL && cache->Invalidate(addr))
+		stats[cpu * N_CACHE_LEVELS + level].invalidations++;
+}
+
+void CacheModel::Fetch(Word addr, Processor* cpu)
+{
+	if (MMIO_BASE <= addr && addr < MMIO_END)
+		return;
+
+	Word latency = access(cpu->getId(), CACHE_L1I, addr);
+	if (stall && latency > 0)
+		cpu->Stall(latency);
+}
+
+void CacheModel::Read(Word addr, Processor* cpu)
+{
+	if (MMIO_BASE <= addr && addr < MMIO_END)
+		return;
+
+	Word latency = access(cpu->getId(), CACHE_L1D, addr);
+	if (stall && latency > 0)
+		cpu->Stall(latency);
+}
+
+void CacheModel::Write(Word addr, Processor* cpu)
+{
+	if (MMIO_BASE <= addr && addr < MMIO_END)
+		return;
+
+	Word id = cpu->getId();
+	for (Word i = 0; i < numCpus; i++) {
+		if (i != id) {
+			invalidate(i, CACHE_L1I, addr);
+			invalidate(i, CACHE_L1D, addr);
+		}
+	}
+
+	// Written through to memory by a write buffer: only a miss stalls
+	// the cpu, while the line is allocated
+	Word latency = access(id, CACHE_L1D, addr);
+	if (stall && latency > 0)
+		cpu->Stall(latency);
+}
+
+void CacheModel::DMA(Word startAddr, Word words)
+{
+	// Step by the smallest line size, so that no line is skipped
+	unsigned int shift = 31;
+	for (unsigned int i = 0; i < N_CACHE_LEVELS; i++) {
+		Cache* cache = getCache(0, (CacheLevel) i);
+		if (cache != NULL && cache->getLineShift() < shift)
+			shift = cache->getLineShift();
+	}
+
+	Word endAddr = startAddr + words * WS;
+	for (Word addr = startAddr & ~((1U << shift) - 1); addr < endAddr; addr += 1U << shift) {
+		for (Word cpu = 0; cpu < numCpus; cpu++) {
+			invalidate(cpu, CACHE_L1I, addr);
+			invalidate(cpu, CACHE_L1D, addr);
+		}
+		if (l2)
+			l2->Invalidate(addr);
+	}
+}
+
+void CacheModel::Reset()
+{
+	for (unsigned int i = 0; i < 2 * numCpus; i++)
+		if (l1[i])
+			l1[i]->Flush();
+	if (l2)
+		l2->Flush();
+
+	memset(stats.get(), 0, sizeof(CacheStats) * numCpus * N_CACHE_LEVELS);
+}
@@ -0,0 +1,124 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_CACHE_MODEL_H
+#define UMPS_CACHE_MODEL_H
+
+#include "base/lang.h"
+#include "umps/machine_config.h"
+
+class Processor;
+
+// Per-cpu counters of a cache level; invalidations are lines dropped
+// because another cpu or a device wrote to them
+struct CacheStats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t invalidations;
+};
+
+/*
+ * A set-associative cache with LRU replacement. Only tags are kept:
+ * data always comes from memory, the cache just tells hits from
+ * misses.
+ */
+class Cache {
+public:
+	Cache(unsigned int kb, unsigned int ways, unsigned int lineSize);
+
+	// Look addr up, allocating its line on a miss; returns true on a hit
+	bool Lookup(Word addr);
+	// Drop the line holding addr, if any; returns true if it was there
+	bool Invalidate(Word addr);
+	void Flush();
+
+	unsigned int getLineShift() const {
+		return lineShift;
+	}
+
+private:
+	unsigned int lineShift;
+	unsigned int ways;
+	unsigned int sets;
+
+	// Tags are line numbers plus one, so that 0 marks an invalid way
+	scoped_array<Word> tags;
+	scoped_array<uint64_t> stamps;
+	uint64_t clock;
+
+	DISABLE_COPY_AND_ASSIGNMENT(Cache);
+};
+
+/*
+ * CacheModel simulates a cache hierarchy, as configured in
+ * MachineConfig: private L1 instruction and data caches for each cpu
+ * and an optional L2 shared by all of them. It is fed with the
+ * physical addresses of fetches and data accesses, and keeps per-cpu
+ * hit/miss counters for each level.
+ *
+ * Data caches are write-through and write-allocate; a write drops
+ * the line from the L1 caches of all other cpus, so does a device
+ * DMA transfer to memory from every cache. Device registers are not
+ * cached. If stalls are enabled, the latency of a miss is charged to
+ * the cpu as stall cycles.
+ */
+class CacheModel {
+public:
+	CacheModel(const MachineConfig* config);
+	~CacheModel();
+
+	void Fetch(Word addr, Processor* cpu);
+	void Read(Word addr, Processor* cpu);
+	void Write(Word addr, Processor* cpu);
+	void DMA(Word startAddr, Word words);
+
+	unsigned int getNumProcessors() const {
+		return numCpus;
+	}
+	// Whether a level is simulated at all (size is not 0)
+	bool hasLevel(CacheLevel level) const;
+	const CacheStats& getStats(Word cpu, CacheLevel level) const {
+		return stats[cpu * N_CACHE_LEVELS + level];
+	}
+
+	// Empty all caches and clear counters
+	void Reset();
+
+private:
+	Cache* getCache(Word cpu, CacheLevel level) const;
+	Word access(Word cpu, CacheLevel level, Word addr);
+	void invalidate(Word cpu, CacheLevel level, Word addr);
+
+	const unsigned int numCpus;
+	const unsigned int l2Latency;
+	const unsigned int memoryLatency;
+	const bool stall;
+
+	// L1 caches of cpu n are l1[2n] (instructions), l1[2n + 1] (data)
+	scoped_array< scoped_ptr<Cache> > l1;
+	scoped_ptr<Cache> l2;
+
+	scoped_array<CacheStats> stats;
+
+	DISABLE_COPY_AND_ASSIGNMENT(CacheModel);
+};
+
+#endif // UMPS_CACHE_MODEL_H
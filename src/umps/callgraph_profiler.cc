@@ -0,0 +1,323 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/callgraph_profiler.h"
+
+#include "umps/const.h"
+#include "umps/error.h"
+#include "umps/machine.h"
+#include "umps/processor_defs.h"
+#include "umps/symbol_table.h"
+#include "umps/systembus.h"
+
+// RFE is the only cop0 instruction with this function code
+#define RFE_MASK    0xFE00003FUL
+#define RFE_INSTR   0x42000010UL
+
+#define REG_RA 31
+
+CallGraphProfiler::CpuState::CpuState()
+	: lost(0),
+	  lastCycle(0),
+	  lastASID(0),
+	  lastUser(false),
+	  pending(PENDING_NONE),
+	  delaySlot(0),
+	  target(0)
+{
+}
+
+CallGraphProfiler::CallGraphProfiler(const MachineConfig* config, Machine* machine)
+	: machine(machine),
+	  fileName(config->getCallGraphFile()),
+	  cpus(new CpuState[config->getNumProcessors()]),
+	  numCpus(config->getNumProcessors())
+{
+	file = fopen(fileName.c_str(), "w");
+	if (file == NULL)
+		throw FileError(fileName);
+
+	// Without a symbol table functions are just addresses
+	try {
+		stab.reset(new SymbolTable(config->getSymbolTableASID(),
+		                           config->getROM(ROM_TYPE_STAB).c_str()));
+	} catch (const Error& e) {
+		stab.reset();
+	}
+}
+
+CallGraphProfiler::~CallGraphProfiler()
+{
+	uint64_t now = machine->getBus()->getToD();
+
+	// Close the frames still open
+	for (unsigned int cpu = 0; cpu < numCpus; cpu++) {
+		CpuState* st = &cpus[cpu];
+		if (!st->stack.empty())
+			funcs[st->stack.back().func].self += now - st->lastCycle;
+		while (!st->stack.empty())
+			pop(st, now);
+	}
+
+	writeProfile();
+	fclose(file);
+}
+
+void CallGraphProfiler::Execute(Word cpu, uint64_t cycle, Word pc, Word instr, Word asid, bool user)
+{
+	CpuState* st = &cpus[cpu];
+
+	// Charge the previous instruction (and any idle time after it)
+	if (!st->stack.empty())
+		funcs[st->stack.back().func].self += cycle - st->lastCycle;
+	st->lastCycle = cycle;
+	st->lastASID = asid;
+	st->lastUser = user;
+
+	switch (st->pending) {
+	case PENDING_CALL:
+		if (pc == st->delaySlot)
+			break;
+		// A linking branch not taken falls through to the link address
+		if (pc != st->target)
+			push(st, lookup(pc, asid, user), st->target, cycle, false);
+		st->pending = PENDING_NONE;
+		break;
+	case PENDING_RETURN:
+		if (pc == st->delaySlot)
+			break;
+		unwindTo(st, pc, false, lookup(pc, asid, user), cycle);
+		st->pending = PENDING_NONE;
+		break;
+	case PENDING_EXCEPTION:
+		push(st, lookup(pc, asid, user), st->target, cycle, true);
+		st->pending = PENDING_NONE;
+		break;
+	case PENDING_RFE:
+		unwindTo(st, pc, true, lookup(pc, asid, user), cycle);
+		st->pending = PENDING_NONE;
+		break;
+	default:
+		break;
+	}
+
+	if (st->stack.empty())
+		push(st, lookup(pc, asid, user), 0, cycle, false);
+
+	switch (OPCODE(instr)) {
+	case 0:
+		// SPECIAL field is 0: REGTYPE instruction
+		if (FUNCT(instr) == SFN_JALR || (FUNCT(instr) == SFN_JR && RS(instr) == REG_RA)) {
+			st->pending = (FUNCT(instr) == SFN_JALR) ? PENDING_CALL : PENDING_RETURN;
+			st->delaySlot = pc + WS;
+			st->target = pc + 2 * WS;
+		}
+		break;
+	case BGL:
+		if (RT(instr) == BGEZAL || RT(instr) == BLTZAL) {
+			st->pending = PENDING_CALL;
+			st->delaySlot = pc + WS;
+			st->target = pc + 2 * WS;
+		}
+		break;
+	case JAL:
+		st->pending = PENDING_CALL;
+		st->delaySlot = pc + WS;
+		st->target = pc + 2 * WS;
+		break;
+	default:
+		if ((instr & RFE_MASK) == RFE_INSTR)
+			st->pending = PENDING_RFE;
+		break;
+	}
+}
+
+void CallGraphProfiler::Exception(Word cpu, Word epc)
+{
+	CpuState* st = &cpus[cpu];
+
+	// A call or return whose delay slot completed has already
+	// transferred control, even if the target never got to run;
+	// otherwise the branch is nullified and will be executed again
+	if (st->pending == PENDING_CALL || st->pending == PENDING_RETURN) {
+		if (epc != st->delaySlot - WS) {
+			FuncId func = lookup(epc, st->lastASID, st->lastUser);
+			if (st->pending == PENDING_CALL && epc != st->target)
+				push(st, func, st->target, st->lastCycle, false);
+			else if (st->pending == PENDING_RETURN)
+				unwindTo(st, epc, false, func, st->lastCycle);
+		}
+	}
+
+	st->pending = PENDING_EXCEPTION;
+	st->target = epc;
+}
+
+CallGraphProfiler::FuncId CallGraphProfiler::lookup(Word pc, Word asid, bool user) const
+{
+	Word domain = user ? asid : MAXASID;
+	Word start = pc;
+
+	if (stab != NULL && (stab->getASID() == MAXASID || stab->getASID() == asid)) {
+		const Symbol* sym = stab->Probe(stab->getASID(), pc, false);
+		if (sym != NULL)
+			start = sym->getStart();
+	}
+
+	return ((FuncId) domain << 32) | start;
+}
+
+void CallGraphProfiler::push(CpuState* st, FuncId func, Word retAddr, uint64_t cycle, bool exception)
+{
+	if (st->stack.size() >= kMaxDepth) {
+		st->lost++;
+		return;
+	}
+
+	if (!st->stack.empty()) {
+		funcs[func].calls++;
+		callEdges[std::make_pair(st->stack.back().func, func)].calls++;
+	} else {
+		funcs[func];
+	}
+
+	st->stack.push_back(Frame{func, retAddr, cycle, exception});
+}
+
+void CallGraphProfiler::pop(CpuState* st, uint64_t cycle)
+{
+	Frame frame = st->stack.back();
+	st->stack.pop_back();
+
+	uint64_t cost = cycle - frame.entry;
+
+	// Recursive activations are part of the outermost one
+	bool outermost = true;
+	for (const Frame& f : st->stack)
+		if (f.func == frame.func)
+			outermost = false;
+	if (outermost)
+		funcs[frame.func].inclusive += cost;
+
+	if (!st->stack.empty())
+		callEdges[std::make_pair(st->stack.back().func, frame.func)].inclusive += cost;
+}
+
+// This method pops the frames a return to pc (from a function, or from
+// an exception if exception is set) closes; if the stack has no such
+// frame, control did not go back where we know of, and a new stack
+// is started from func
+void CallGraphProfiler::unwindTo(CpuState* st, Word pc, bool exception, FuncId func, uint64_t cycle)
+{
+	size_t i = st->stack.size();
+
+	if (exception) {
+		// Handlers usually return through a BIOS service (LDST is a
+		// BREAK), whose exception frame is on top of the one being
+		// returned from: search all exception frames, closing the
+		// ones above. SYSCALL and BREAK resume past the trapping
+		// instruction
+		while (i > 0 && !(st->stack[i - 1].exception &&
+		                  (st->stack[i - 1].retAddr == pc || st->stack[i - 1].retAddr + WS == pc)))
+			i--;
+	} else {
+		while (i > 0 && st->stack[i - 1].retAddr != pc)
+			i--;
+	}
+
+	if (i > 0) {
+		while (st->stack.size() >= i)
+			pop(st, cycle);
+	} else if (!exception && st->lost > 0) {
+		st->lost--;
+	} else {
+		st->lost = 0;
+		while (!st->stack.empty())
+			pop(st, cycle);
+		push(st, func, 0, cycle, false);
+	}
+}
+
+std::string CallGraphProfiler::funcName(FuncId func) const
+{
+	Word domain = (Word) (func >> 32);
+	Word start = (Word) func;
+	const char* name = NULL;
+	char buf[32];
+
+	if (stab != NULL && (stab->getASID() == MAXASID || stab->getASID() == domain)) {
+		const Symbol* sym = stab->Probe(stab->getASID(), start, false);
+		if (sym != NULL)
+			name = sym->getName();
+	}
+	if (name == NULL) {
+		snprintf(buf, sizeof(buf), "0x%.8X", start);
+		name = buf;
+	}
+
+	if (domain == MAXASID)
+		return name;
+	snprintf(buf, sizeof(buf), " [asid %u]", domain);
+	return std::string(name) + buf;
+}
+
+// This method writes the profile in the callgrind format, with the
+// function start address as position of all costs
+void CallGraphProfiler::writeProfile()
+{
+	std::map<FuncId, unsigned int> ids;
+	std::vector<bool> named(funcs.size() + 1, false);
+	for (const auto& f : funcs)
+		ids.emplace(f.first, ids.size() + 1);
+
+	// Callgrind name compression: the name only goes with the first
+	// occurrence of an id
+	auto nameRef = [&](FuncId func) {
+		unsigned int id = ids[func];
+		std::string ref = "(" + std::to_string(id) + ")";
+		if (!named[id]) {
+			named[id] = true;
+			ref += " " + funcName(func);
+		}
+		return ref;
+	};
+
+	fprintf(file, "# callgrind format\n");
+	fprintf(file, "version: 1\n");
+	fprintf(file, "creator: umps3\n");
+	fprintf(file, "positions: instr\n");
+	fprintf(file, "events: Cycles\n\n");
+
+	for (const auto& f : funcs) {
+		Word start = (Word) f.first;
+		fprintf(file, "fn=%s\n", nameRef(f.first).c_str());
+		fprintf(file, "0x%X %llu\n", start, (unsigned long long) f.second.self);
+
+		auto it = callEdges.lower_bound(std::make_pair(f.first, (FuncId) 0));
+		for (; it != callEdges.end() && it->first.first == f.first; ++it) {
+			FuncId callee = it->first.second;
+			fprintf(file, "cfn=%s\n", nameRef(callee).c_str());
+			fprintf(file, "calls=%llu 0x%X\n", (unsigned long long) it->second.calls, (Word) callee);
+			fprintf(file, "0x%X %llu\n", start, (unsigned long long) it->second.inclusive);
+		}
+		fprintf(file, "\n");
+	}
+}
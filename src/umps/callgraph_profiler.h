@@ -0,0 +1,144 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_CALLGRAPH_PROFILER_H
+#define UMPS_CALLGRAPH_PROFILER_H
+
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/lang.h"
+#include "umps/machine_config.h"
+
+class Machine;
+class SymbolTable;
+
+/*
+ * CallGraphProfiler measures exactly where cycles go, function by
+ * function, as configured in MachineConfig: processors report every
+ * instruction they execute and every exception they take, and the
+ * profiler keeps a shadow call stack for each cpu.
+ *
+ * A frame is pushed when a JAL, JALR, BGEZAL or BLTZAL transfers
+ * control to the callee (after the delay slot), and popped when a
+ * JR $ra returns to the address the call linked. Exceptions push a
+ * frame for the handler; an RFE returning to the pc of an exception
+ * on the stack (or past it, for SYSCALL and BREAK) pops that frame
+ * and the ones above, such as those of the BIOS service the handler
+ * returned through, while one landing elsewhere (a context switch)
+ * starts a new stack. Costs are cycles of the machine clock, so that time spent
+ * idle after a WAIT is charged to the function executing it.
+ *
+ * The profile is written when the profiler is destroyed, in the
+ * callgrind format: self cost of each function, and calls and
+ * inclusive cost of each caller/callee pair.
+ */
+class CallGraphProfiler {
+public:
+	CallGraphProfiler(const MachineConfig* config, Machine* machine);
+	~CallGraphProfiler();
+
+	// An instruction is about to be executed by cpu at the given cycle
+	void Execute(Word cpu, uint64_t cycle, Word pc, Word instr, Word asid, bool user);
+
+	// cpu is taking an exception: the instruction just reported (if
+	// any) is nullified, and the handler will return to epc
+	void Exception(Word cpu, Word epc);
+
+private:
+	static const size_t kMaxDepth = 1024;
+
+	// Functions are identified by their start address, qualified
+	// by the ASID of user code (MAXASID for kernel code)
+	typedef uint64_t FuncId;
+
+	struct Frame {
+		FuncId func;
+		Word retAddr;
+		uint64_t entry;
+		bool exception;
+	};
+
+	enum Pending {
+		PENDING_NONE,
+		PENDING_CALL,
+		PENDING_RETURN,
+		PENDING_EXCEPTION,
+		PENDING_RFE
+	};
+
+	struct CpuState {
+		CpuState();
+
+		std::vector<Frame> stack;
+		// Calls not pushed because the stack was full
+		unsigned int lost;
+		uint64_t lastCycle;
+		Word lastASID;
+		bool lastUser;
+
+		// Control transfer that takes effect with the next
+		// instruction (out of the delay slot, if any)
+		Pending pending;
+		Word delaySlot;
+		Word target;
+	};
+
+	struct FuncStats {
+		uint64_t self;
+		uint64_t inclusive;
+		uint64_t calls;
+	};
+
+	struct CallStats {
+		uint64_t calls;
+		uint64_t inclusive;
+	};
+
+	FuncId lookup(Word pc, Word asid, bool user) const;
+	void push(CpuState* st, FuncId func, Word retAddr, uint64_t cycle, bool exception);
+	void pop(CpuState* st, uint64_t cycle);
+	void unwindTo(CpuState* st, Word pc, bool exception, FuncId func, uint64_t cycle);
+
+	std::string funcName(FuncId func) const;
+	void writeProfile();
+
+	Machine* const machine;
+
+	std::string fileName;
+	FILE* file;
+
+	scoped_ptr<SymbolTable> stab;
+
+	scoped_array<CpuState> cpus;
+	const unsigned int numCpus;
+
+	std::map<FuncId, FuncStats> funcs;
+	std::map<std::pair<FuncId, FuncId>, CallStats> callEdges;
+
+	DISABLE_COPY_AND_ASSIGNMENT(CallGraphProfiler);
+};
+
+#endif // UMPS_CALLGRAPH_PROFILER_H
@@ -0,0 +1,118 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/code_coverage.h"
+
+#include <stdio.h>
+
+#include <map>
+
+#include "umps/error.h"
+#include "umps/symbol_table.h"
+
+CodeCoverage::CodeCoverage(const MachineConfig* config)
+	: ramWords(config->getRamSize() * FRAMESIZE),
+	  bitmap(new uint32_t[(ramWords + 31) / 32]()),
+	  fileName(config->getCoverageFile()),
+	  sourceName(config->getROM(ROM_TYPE_CORE)),
+	  merge(config->isCoverageMergeEnabled())
+{
+	// Find out now if the report cannot be written
+	FILE* file = fopen(fileName.c_str(), "a");
+	if (file == NULL)
+		throw FileError(fileName);
+	fclose(file);
+
+	// Only kernel symbols can be mapped to physical addresses
+	if (config->getSymbolTableASID() == MAXASID) {
+		try {
+			stab.reset(new SymbolTable(MAXASID, config->getROM(ROM_TYPE_STAB).c_str()));
+		} catch (const Error& e) {
+			stab.reset();
+		}
+	}
+}
+
+CodeCoverage::~CodeCoverage()
+{
+	writeReport();
+}
+
+bool CodeCoverage::executed(Word addr) const
+{
+	Word index = (addr - RAMBASE) >> WORDSHIFT;
+	return index < ramWords && (bitmap[index >> 5] & (1U << (index & 31)));
+}
+
+void CodeCoverage::writeReport()
+{
+	// Run counts of each address, from the previous report if merging
+	std::map<Word, unsigned long> counts;
+
+	FILE* file;
+	if (merge && (file = fopen(fileName.c_str(), "r")) != NULL) {
+		char line[256];
+		unsigned int addr;
+		unsigned long count;
+		while (fgets(line, sizeof(line), file) != NULL)
+			if (sscanf(line, "DA:%u,%lu", &addr, &count) == 2)
+				counts[addr] += count;
+		fclose(file);
+	}
+
+	if ((file = fopen(fileName.c_str(), "w")) == NULL)
+		return;
+
+	fprintf(file, "TN:\nSF:%s\n", sourceName.c_str());
+
+	if (stab != NULL) {
+		unsigned int found = 0, hit = 0;
+		for (unsigned int i = 0; i < stab->Size(); i++) {
+			const Symbol* sym = stab->Get(i);
+			if (sym->getType() != Symbol::TYPE_FUNCTION)
+				continue;
+			for (Word addr = sym->getStart(); addr <= sym->getEnd(); addr += WS)
+				counts[addr] += executed(addr);
+
+			unsigned long entries = counts[sym->getStart()];
+			fprintf(file, "FN:%u,%s\n", sym->getStart(), sym->getName());
+			fprintf(file, "FNDA:%lu,%s\n", entries, sym->getName());
+			found++;
+			if (entries > 0)
+				hit++;
+		}
+		fprintf(file, "FNF:%u\nFNH:%u\n", found, hit);
+	} else {
+		for (Word index = 0; index < ramWords; index++)
+			if (bitmap[index >> 5] & (1U << (index & 31)))
+				counts[RAMBASE + (index << WORDSHIFT)]++;
+	}
+
+	unsigned int hit = 0;
+	for (const auto& c : counts) {
+		fprintf(file, "DA:%u,%lu\n", c.first, c.second);
+		if (c.second > 0)
+			hit++;
+	}
+	fprintf(file, "LF:%u\nLH:%u\nend_of_record\n", (unsigned int) counts.size(), hit);
+
+	fclose(file);
+}
@@ -0,0 +1,73 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_CODE_COVERAGE_H
+#define UMPS_CODE_COVERAGE_H
+
+#include <string>
+
+#include "base/lang.h"
+#include "umps/const.h"
+#include "umps/machine_config.h"
+
+class SymbolTable;
+
+/*
+ * CodeCoverage records which words of RAM were fetched as
+ * instructions, in a bitmap filled by the bus, and writes a coverage
+ * report when destroyed, as configured in MachineConfig.
+ *
+ * The report is an lcov tracefile where "lines" are instruction
+ * addresses: with a kernel symbol table (ASID 0x40, whose addresses
+ * are physical ones) every function is listed along with all its
+ * words; otherwise, just the words executed are. Counts are the
+ * number of runs which executed each word, so that reports of many
+ * runs can be merged, by lcov or by the simulator itself.
+ */
+class CodeCoverage {
+public:
+	CodeCoverage(const MachineConfig* config);
+	~CodeCoverage();
+
+	// Record an instruction fetch from physical address addr
+	void Fetch(Word addr) {
+		Word index = (addr - RAMBASE) >> WORDSHIFT;
+		if (index < ramWords)
+			bitmap[index >> 5] |= 1U << (index & 31);
+	}
+
+private:
+	bool executed(Word addr) const;
+	void writeReport();
+
+	const Word ramWords;
+	scoped_array<uint32_t> bitmap;
+
+	std::string fileName;
+	std::string sourceName;
+	const bool merge;
+
+	scoped_ptr<SymbolTable> stab;
+
+	DISABLE_COPY_AND_ASSIGNMENT(CodeCoverage);
+};
+
+#endif // UMPS_CODE_COVERAGE_H
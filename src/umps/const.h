@@ -142,12 +142,13 @@
 
 // bus memory mapping constants (BIOS/BIOS Data Page/device registers/BOOT/RAM)
 #define BIOSBASE    0x00000000UL
-#define BIOSDATABASE  0x0FFFF000UL
+#define BIOSDATABASE  0x0FFFC000UL
 #define DEVBASE     0x10000000UL
 #define BOOTBASE    0x1FC00000UL
 #define RAMBASE     0x20000000UL
 
-// size of bios data page (in words)
+// size of bios data area (in words): the bios data page, preceded by
+// exception state vectors of processors past the 16th
 #define BIOSDATASIZE ((DEVBASE - BIOSDATABASE) / WORDLEN)
 
 // Processor structure register numbers
@@ -35,6 +35,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 #include <boost/bind/bind.hpp>
 
@@ -125,6 +128,15 @@ HIDDEN char strbuf[STRBUFSIZE];
 // this means a throughput of about 12.5 KB/s
 
 
+// Printer and terminal log files output buffering
+
+// buffer size (bytes)
+#define OUTBUFSIZE      4096
+
+// max time buffered output may wait for a flush (microsecs)
+#define OUTFLUSHTIME    100000
+
+
 // DiskDevice specific commands / status codes
 
 // controller reset time (microsecs)
@@ -143,6 +155,9 @@ HIDDEN char strbuf[STRBUFSIZE];
 #define DWRITERR 6
 #define DDMAERR  7
 
+// track cache: sector not (or no longer going to be) available
+#define SECTNOTREADY    (~((uint64_t) 0))
+
 
 // FlashDevice specific commands / status codes
 
@@ -198,6 +213,12 @@ HIDDEN char strbuf[STRBUFSIZE];
 // has been successful or not
 HIDDEN const char * isSuccess(unsigned int devType, Word regVal);
 
+// This function tells if the STATUS field holds an error code
+HIDDEN bool opFailed(unsigned int devType, Word regVal);
+
+// This function sets up log file buffering according to the given policy
+HIDDEN void setupOutput(FILE * file, unsigned int policy);
+
 
 /****************************************************************************/
 /* Definitions to be exported.                                              */
@@ -221,6 +242,9 @@ Device::Device(SystemBus * busl, unsigned int intl, unsigned int dnum)
 	complTime = UINT64_C(0);
 	// a NULLDEV never works
 	isWorking = false;
+	for (unsigned int i = 0; i < kMaxUnits; i++)
+		units[i].busy = units[i].done = false;
+	outputFlushScheduled = false;
 }
 
 // No operation for "uninstalled" devices
@@ -252,6 +276,17 @@ const char* Device::getDevSStr()
 	return "Not operational";
 }
 
+// No buffered output for most devices
+void Device::FlushOutput()
+{
+}
+
+// No host input to wait for by default
+bool Device::PollHostInput()
+{
+	return false;
+}
+
 // This method returns the current value for device register field indexed
 // by regnum
 Word Device::ReadDevReg(unsigned int regnum)
@@ -319,9 +354,109 @@ bool Device::isBusy() const
 	return reg[STATUS] == BUSY;
 }
 
+unsigned int Device::getBusyUnits() const
+{
+	unsigned int busy = 0;
+	for (unsigned int i = 0; i < getNumUnits(); i++)
+		if (getUnitStatus(i) == BUSY)
+			busy |= 1U << i;
+	return busy;
+}
+
+unsigned int Device::getQueueDepth() const
+{
+	unsigned int depth = 0;
+	for (unsigned int i = 0; i < getNumUnits(); i++)
+		if (units[i].busy || units[i].done)
+			depth++;
+	return depth;
+}
+
+unsigned int Device::getNumUnits() const
+{
+	return 1;
+}
+
+Word Device::getUnitStatus(unsigned int unit) const
+{
+	UNUSED_ARG(unit);
+	return reg[STATUS];
+}
+
+// A command started an operation, was rejected with an error status
+// (waiting for ACK as a completed operation does), or else (ACK) did
+// not start anything. Any command takes a completed operation.
+void Device::AccountRegWrite(unsigned int regnum)
+{
+	unsigned int unit = regnum / 2;
+	if (dType == NULLDEV || regnum % 2 != 1 || unit >= getNumUnits())
+		return;
+
+	UnitState& u = units[unit];
+	Word status = getUnitStatus(unit);
+	uint64_t now = bus->getToD();
+
+	if (u.busy)
+		return;
+
+	if (u.done) {
+		stats.queueCycles += now - u.doneAt;
+		stats.queueWaits++;
+		u.done = false;
+	}
+
+	if (status == BUSY) {
+		stats.commands++;
+		u.busy = true;
+		u.busySince = now;
+	} else if (opFailed(dType, status)) {
+		stats.commands++;
+		stats.errors++;
+		u.done = true;
+		u.doneAt = now;
+	}
+}
+
 uint64_t Device::scheduleIOEvent(uint64_t delay)
 {
-	return bus->scheduleEvent(delay, boost::bind(&Device::CompleteDevOp, this));
+	return bus->scheduleEvent(delay, boost::bind(&Device::completeIOEvent, this));
+}
+
+void Device::scheduleOutputFlush(uint64_t delay)
+{
+	if (!outputFlushScheduled) {
+		outputFlushScheduled = true;
+		bus->scheduleEvent(delay, boost::bind(&Device::outputFlushEvent, this));
+	}
+}
+
+void Device::outputFlushEvent()
+{
+	outputFlushScheduled = false;
+	FlushOutput();
+}
+
+// This method is the callback of scheduled operations: it completes
+// the operation, and lets the bus know the device status changed
+void Device::completeIOEvent()
+{
+	CompleteDevOp();
+
+	uint64_t now = bus->getToD();
+	for (unsigned int i = 0; i < getNumUnits(); i++) {
+		UnitState& u = units[i];
+		Word status = getUnitStatus(i);
+		if (!u.busy || status == BUSY)
+			continue;
+		stats.busyCycles += now - u.busySince;
+		if (opFailed(dType, status))
+			stats.errors++;
+		u.busy = false;
+		u.done = true;
+		u.doneAt = now;
+	}
+
+	bus->DeviceStatusChanged(this);
 }
 
 /****************************************************************************/
@@ -353,6 +488,8 @@ PrinterDevice::PrinterDevice(SystemBus* bus, const MachineConfig* cfg,
 		sprintf(strbuf, "Cannot open printer %u file : %s", devNum, strerror(errno));
 		Panic(strbuf);
 	}
+	outBuffering = config->getOutputBuffering(il, devNo);
+	setupOutput(prntFile, outBuffering);
 }
 
 PrinterDevice::~PrinterDevice()
@@ -427,6 +564,11 @@ const char* PrinterDevice::getDevSStr()
 	return statStr;
 }
 
+void PrinterDevice::FlushOutput()
+{
+	fflush(prntFile);
+}
+
 unsigned int PrinterDevice::CompleteDevOp()
 {
 	// checks which operation must be completed: for each, sets device
@@ -447,7 +589,8 @@ unsigned int PrinterDevice::CompleteDevOp()
 				sprintf(strbuf, "Error writing printer %u file : %s", devNum, strerror(errno));
 				Panic(strbuf);
 			}
-			fflush(prntFile);
+			if (outBuffering != OUTPUT_UNBUFFERED)
+				scheduleOutputFlush(OUTFLUSHTIME * config->getClockRate());
 			sprintf(statStr, "Printed char 0x%.2X : waiting for ACK", (unsigned char) reg[DATA0]);
 			reg[STATUS] = READY;
 		} else {
@@ -479,6 +622,7 @@ unsigned int PrinterDevice::CompleteDevOp()
 // a pointer to SetupInfo object containing terminal log file name;
 // a static buffer for device operation & status description;
 // a FILE structure for log file access;
+// an optional host input source (file, FIFO or pty) feeding the receiver;
 // some structures for handling terminal transmitter and receiver.
 
 //
@@ -492,14 +636,15 @@ TerminalDevice::TerminalDevice(SystemBus* bus, const MachineConfig* cfg,
 {
 	dType = TERMDEV;
 	isWorking = true;
-	recvBuf = NULL;
-	recvBp = 0;
+	recvHead = recvCount = 0;
+	inputFd = -1;
 	reg[RECVSTATUS] = READY;
 	reg[TRANSTATUS] = READY;
 	sprintf(recvStatStr, "Idle");
 	sprintf(tranStatStr, "Idle");
 	recvCTime = UINT64_C(0);
 	tranCTime = UINT64_C(0);
+	recvParked = false;
 	recvIntPend = false;
 	tranIntPend = false;
 
@@ -508,13 +653,25 @@ TerminalDevice::TerminalDevice(SystemBus* bus, const MachineConfig* cfg,
 		sprintf(strbuf, "Cannot open terminal %u file : %s", devNum, strerror(errno));
 		Panic(strbuf);
 	}
-	// else file has been open with success: set it to no buffering for quick
-	// terminal screen update
-	setvbuf(termFile, (char *) NULL, _IONBF, 0);
+	// else file has been open with success: set up buffering (terminal
+	// screen is updated through SignalTransmitted anyway)
+	outBuffering = config->getOutputBuffering(il, devNo);
+	setupOutput(termFile, outBuffering);
+
+	// host input source, if any, is read without ever blocking the
+	// simulation
+	const std::string& input = config->getTerminalInput(devNo);
+	if (!input.empty() && (inputFd = open(input.c_str(), O_RDONLY | O_NONBLOCK | O_NOCTTY)) < 0) {
+		sprintf(strbuf, "Cannot open terminal %u input %s : %s", devNum, input.c_str(), strerror(errno));
+		Panic(strbuf);
+	}
 }
 
 TerminalDevice::~TerminalDevice()
 {
+	if (inputFd >= 0)
+		close(inputFd);
+
 	if (fclose(termFile) == EOF) {
 		sprintf(strbuf, "Cannot close terminal file %u : %s", devNum, strerror(errno));
 		Panic(strbuf);
@@ -642,6 +799,11 @@ const char* TerminalDevice::getDevSStr()
 	return strbuf;
 }
 
+void TerminalDevice::FlushOutput()
+{
+	fflush(termFile);
+}
+
 const char* TerminalDevice::getTXStatus() const
 {
 	return tranStatStr;
@@ -667,32 +829,45 @@ std::string TerminalDevice::getTXCTimeInfo() const
 
 std::string TerminalDevice::getRXCTimeInfo() const
 {
-	if (reg[RECVSTATUS] == BUSY)
+	if (reg[RECVSTATUS] == BUSY && !recvParked)
 		return TimeStamp::toString(recvCTime);
 	else
 		return "";
 }
 
+// Receiver and transmitter are sub-devices 0 and 1; a receiver waiting
+// for host input is busy too
+unsigned int TerminalDevice::getNumUnits() const
+{
+	return 2;
+}
+
+Word TerminalDevice::getUnitStatus(unsigned int unit) const
+{
+	return reg[unit == 0 ? RECVSTATUS : TRANSTATUS] & BYTEMASK;
+}
+
 unsigned int TerminalDevice::CompleteDevOp()
 {
 	// only one sub-device should complete its op: which one?
 	bool doRecv;
 	unsigned int devMod;
 
-	// determines which operation must be completed
-	if (reg[RECVSTATUS] == BUSY && reg[TRANSTATUS] == BUSY) {
+	// determines which operation must be completed (a parked receiver
+	// has no completion event scheduled)
+	if (reg[RECVSTATUS] == BUSY && !recvParked && reg[TRANSTATUS] == BUSY) {
 		// Both sub-devices are working, so tie breaking depends on
 		// timestamps: lower is first. If they are equal, this doesn't
 		// matter because there will be another CompleteDevOp
 		// following, and one sub-device will have already completed
-		// its op or posponed it (recv).
+		// its op or parked (recv).
 		if (recvCTime <= tranCTime)
 			doRecv = true;
 		else
 			doRecv = false;
 	} else {
-		// Surely one or other sub-device is idle
-		doRecv = (reg[RECVSTATUS] == BUSY);
+		// Surely one or other sub-device is idle or parked
+		doRecv = (reg[RECVSTATUS] == BUSY && !recvParked);
 	}
 
 	if (doRecv) {
@@ -711,15 +886,18 @@ unsigned int TerminalDevice::CompleteDevOp()
 			break;
 
 		case RECVCHR:
-			if (recvBuf == NULL || recvBuf[recvBp] == EOS) {
-				// no char in input: wait another receiver cycle
-				recvCTime = scheduleIOEvent(RECVCHRTIME * config->getClockRate());
+			if (recvCount == 0)
+				readInput();
+			if (recvCount == 0) {
+				// no char in input: wait for some to arrive
+				recvPark();
 			} else {
 				// buffer is not empty
 				if (isWorking) {
-					sprintf(recvStatStr, "Received char 0x%.2X : waiting for ACK", recvBuf[recvBp]);
-					reg[RECVSTATUS] = (((Word) recvBuf[recvBp]) << BYTELEN) | RECVD;
-					recvBp++;
+					sprintf(recvStatStr, "Received char 0x%.2X : waiting for ACK", recvBuf[recvHead]);
+					reg[RECVSTATUS] = (((Word) recvBuf[recvHead]) << BYTELEN) | RECVD;
+					recvHead = (recvHead + 1) % TERMRECVBUFSIZE;
+					recvCount--;
 				} else {
 					// no operation & error simulation
 					sprintf(recvStatStr, "Error receiving char : waiting for ACK");
@@ -758,7 +936,8 @@ unsigned int TerminalDevice::CompleteDevOp()
 					Panic(strbuf);
 				}
 				// else operation is successful:
-				fflush(termFile);
+				if (outBuffering != OUTPUT_UNBUFFERED)
+					scheduleOutputFlush(OUTFLUSHTIME * config->getClockRate());
 				SignalTransmitted.emit((unsigned char) ((reg[TRANCOMMAND] >> BYTELEN) & BYTEMASK));
 				sprintf(tranStatStr, "Transm. char 0x%.2lX : waiting for ACK",
 				        (reg[TRANCOMMAND] >> BYTELEN) & BYTEMASK);
@@ -787,27 +966,11 @@ unsigned int TerminalDevice::CompleteDevOp()
 
 void TerminalDevice::Input(const char* inputstr)
 {
-	char* strp;
-
-	if (recvBuf != NULL && recvBuf[recvBp] == EOS) {
-		// buffer exausted: delete it
-		delete recvBuf;
-		recvBuf = NULL;
-	}
-
-	if (recvBuf == NULL) {
-		// simply copies inputstr into it, adding a trailing '\n'
-		recvBuf = new char[strlen(inputstr) + 2];
-		sprintf(recvBuf, "%s\n", inputstr);
-	} else {
-		// copies the unreceived buffer part plus the new input into
-		// a new buffer
-		strp = new char [(strlen(recvBuf) - recvBp) + strlen(inputstr) + 2];
-		sprintf(strp, "%s%s\n",&(recvBuf[recvBp]), inputstr);
-		delete recvBuf;
-		recvBuf = strp;
-	}
-	recvBp = 0;
+	// appends inputstr to receiver buffer, adding a trailing '\n'
+	recvPut((const unsigned char *) inputstr, strlen(inputstr));
+	recvPut((const unsigned char *) "\n", 1);
+	if (recvParked)
+		recvWake();
 
 	// writes input to log file
 	if (fprintf(termFile, "%s\n", inputstr) < 0) {
@@ -816,12 +979,99 @@ void TerminalDevice::Input(const char* inputstr)
 	}
 }
 
+// This method appends len characters to the receiver buffer; whatever
+// does not fit is lost
+void TerminalDevice::recvPut(const unsigned char * data, unsigned int len)
+{
+	unsigned int tail;
+
+	if (len > TERMRECVBUFSIZE - recvCount)
+		len = TERMRECVBUFSIZE - recvCount;
+
+	for (unsigned int i = 0; i < len; i++) {
+		tail = (recvHead + recvCount) % TERMRECVBUFSIZE;
+		recvBuf[tail] = data[i];
+		recvCount++;
+	}
+}
+
+// This method checks the host input source for a parked receiver
+bool TerminalDevice::PollHostInput()
+{
+	if (!recvParked)
+		return false;
+
+	readInput();
+	if (recvCount > 0) {
+		// complete reception one char time from now (no recvWake():
+		// SystemBus is scanning its waiting list)
+		recvParked = false;
+		recvCTime = scheduleIOEvent(RECVCHRTIME * config->getClockRate());
+		return false;
+	}
+	// keep waiting unless input source is gone
+	return (inputFd >= 0);
+}
+
+// This method parks the receiver until some input arrives: from the
+// GUI through Input(), or from the host input source, if any
+void TerminalDevice::recvPark()
+{
+	recvParked = true;
+	if (inputFd >= 0)
+		bus->WatchHostInput(this);
+}
+
+// This method resumes a parked receiver: reception completes one char
+// time from now
+void TerminalDevice::recvWake()
+{
+	recvParked = false;
+	bus->UnwatchHostInput(this);
+	recvCTime = scheduleIOEvent(RECVCHRTIME * config->getClockRate());
+}
+
+// This method refills the (empty) receiver buffer from the host input
+// source, if any, without blocking: a regular file is closed at EOF, while
+// a FIFO or pty is kept open since more input may always come
+void TerminalDevice::readInput()
+{
+	ssize_t len;
+	struct stat st;
+
+	if (inputFd < 0)
+		return;
+
+	recvHead = 0;
+	do
+		len = read(inputFd, recvBuf, TERMRECVBUFSIZE);
+	while (len < 0 && errno == EINTR);
+
+	if (len > 0) {
+		recvCount = len;
+		// writes input to log file
+		if (fwrite(recvBuf, 1, len, termFile) != (size_t) len) {
+			sprintf(strbuf, "Error writing terminal %u file : %s", devNum, strerror(errno));
+			Panic(strbuf);
+		}
+	} else if ((len == 0 && fstat(inputFd, &st) == 0 && S_ISREG(st.st_mode)) ||
+	           (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+		// end of file, or input source gone for good
+		close(inputFd);
+		inputFd = -1;
+	}
+}
+
 
 // DiskDevice class allows to emulate a disk drive: each 4096 byte sector it
 // contains is identified by (cyl, head, sect) set of disk coordinates;
 // (geometry and performance figures are loaded from disk image file).
 // Operations on sectors (R/W) require previous seek on the desired cylinder.
 // It also contains a sector buffer of one sector to speed up operations.
+// If configured, a cache of whole tracks models the read-ahead of real
+// drives: a read miss fetches the whole track, whose sectors then become
+// available as they pass under the head, as long as the drive keeps
+// reading ahead (i.e. until the next seek, write or read miss).
 //
 // It uses the same interface as Device, redefining only a few methods'
 // implementation: refer to it for individual methods descriptions.
@@ -832,6 +1082,7 @@ void TerminalDevice::Input(const char* inputstr)
 // a FILE structure for disk image file access;
 // a set of disk parameters (read from disk image file header);
 // a Block object for file handling;
+// a track cache with its hit/miss counters;
 // some items for performance computation.
 
 DiskDevice::DiskDevice(SystemBus* bus, const MachineConfig* cfg,
@@ -867,12 +1118,34 @@ DiskDevice::DiskDevice(SystemBus* bus, const MachineConfig* cfg,
 	currCyl = 0;
 	sectTicks = (diskP->getRotTime() * config->getClockRate()) / diskP->getSectNum();
 	cylBuf = headBuf = sectBuf = MAXWORDVAL;
+
+	// track cache setup
+	cacheTracks = config->getDiskCacheTracks(devNum);
+	cacheHits = cacheMisses = 0;
+	if (cacheTracks > 0) {
+		cacheSlot = new TrackSlot[cacheTracks];
+		cacheBuf = new Block[cacheTracks * diskP->getSectNum()];
+		cacheReady = new uint64_t[cacheTracks * diskP->getSectNum()];
+		for (unsigned int i = 0; i < cacheTracks; i++) {
+			cacheSlot[i].cyl = cacheSlot[i].head = MAXWORDVAL;
+			cacheSlot[i].lastUse = 0;
+		}
+		for (unsigned int i = 0; i < cacheTracks * diskP->getSectNum(); i++)
+			cacheReady[i] = SECTNOTREADY;
+	} else {
+		cacheSlot = NULL;
+		cacheBuf = NULL;
+		cacheReady = NULL;
+	}
 }
 
 DiskDevice::~DiskDevice()
 {
 	delete diskBuf;
 	delete diskP;
+	delete [] cacheSlot;
+	delete [] cacheBuf;
+	delete [] cacheReady;
 
 	if (fclose(diskFile) == EOF) {
 		sprintf(strbuf, "Cannot close disk file %u : %s", devNum, strerror(errno));
@@ -889,7 +1162,8 @@ void DiskDevice::WriteDevReg(unsigned int regnum, Word data)
 		return;
 
 	Word timeOfs;
-	unsigned int cyl, head, sect, currSect;
+	unsigned int cyl, head, sect, currSect, slot;
+	uint64_t ready;
 
 	switch (regnum) {
 	case COMMAND:
@@ -920,11 +1194,13 @@ void DiskDevice::WriteDevReg(unsigned int regnum, Word data)
 			if (cyl < diskP->getCylNum()) {
 				bus->IntAck(intL, devNum);
 				sprintf(statStr, "Seeking Cyl 0x%.4X (last op: %s)", cyl, isSuccess(dType, reg[STATUS]));
+				abortReadAhead();
 				// compute movement offset
 				if (cyl < currCyl)
 					cyl = currCyl - cyl;
 				else
 					cyl = cyl - currCyl;
+				seekDistances.Add(cyl);
 				complTime = scheduleIOEvent((diskP->getSeekTime() * cyl * config->getClockRate()) + 1);
 				reg[STATUS] = BUSY;
 			} else {
@@ -946,10 +1222,24 @@ void DiskDevice::WriteDevReg(unsigned int regnum, Word data)
 				if (currCyl == cylBuf && head == headBuf && sect == sectBuf) {
 					// sector is already in disk buffer
 					timeOfs = DMATICKS;
+					cacheHits++;
+				} else if ((slot = cacheLookup(currCyl, head)) < cacheTracks &&
+				           (ready = cacheReady[slot * diskP->getSectNum() + sect]) != SECTNOTREADY) {
+					// sector is in track cache: wait for read-ahead
+					// to get there, if it has not yet
+					cylBuf = headBuf = sectBuf = MAXWORDVAL;
+					timeOfs = DMATICKS;
+					if (ready > bus->getToD())
+						timeOfs += ready - bus->getToD();
+					cacheHits++;
 				} else {
 					// invalidate current buffer
 					cylBuf = headBuf = sectBuf = MAXWORDVAL;
 
+					// drive stops reading ahead to go for this track
+					abortReadAhead();
+					cacheMisses++;
+
 					// compute op completion time
 
 					// use only TodLO for easier computation
@@ -967,6 +1257,7 @@ void DiskDevice::WriteDevReg(unsigned int regnum, Word data)
 					// completion time is = current sect rem. time +
 					//   sectors-in-between time + sector data read +
 					// DMA transfer time
+					rotLatencies.Add(timeOfs + (sectTicks * sect));
 					timeOfs += (sectTicks * sect) + ((sectTicks * diskP->getDataSect()) / 100) + DMATICKS;
 				}
 				complTime = scheduleIOEvent(timeOfs);
@@ -987,12 +1278,14 @@ void DiskDevice::WriteDevReg(unsigned int regnum, Word data)
 			if (head < diskP->getHeadNum() && sect < diskP->getSectNum()) {
 				sprintf(statStr, "Writing C/H/S 0x%.4X/0x%.2X/0x%.2X (last op: %s)",
 				        currCyl, head, sect, isSuccess(dType, reg[STATUS]));
+				abortReadAhead();
 				// DMA transfer from memory
 				if (bus->DMATransfer(diskBuf, reg[DATA0], false)) {
 					// DMA transfer error: invalidate current buffer
 					cylBuf = headBuf = sectBuf = MAXWORDVAL;
 					timeOfs = DMATICKS;
 				} else {
+					stats.dmaBytes += BLOCKSIZE * WORDLEN;
 					// disk sector in buffer from memory
 					cylBuf = currCyl;
 					headBuf = head;
@@ -1015,6 +1308,7 @@ void DiskDevice::WriteDevReg(unsigned int regnum, Word data)
 
 					// completion time is = DMA time + current sect rem. time +
 					//   sectors-in-between time + sector data write
+					rotLatencies.Add(timeOfs - DMATICKS + (sectTicks * sect));
 					timeOfs += (sectTicks * sect) + ((sectTicks * diskP->getDataSect()) / 100);
 				}
 				complTime = scheduleIOEvent(timeOfs);
@@ -1068,6 +1362,9 @@ unsigned int DiskDevice::CompleteDevOp()
 		sprintf(statStr, "Reset completed : waiting for ACK");
 		reg[STATUS] = READY;
 		cylBuf = headBuf = sectBuf = MAXWORDVAL;
+		// and the track cache as well
+		for (unsigned int i = 0; i < cacheTracks; i++)
+			cacheSlot[i].cyl = cacheSlot[i].head = MAXWORDVAL;
 		break;
 
 	case DSEEKCYL:
@@ -1091,7 +1388,8 @@ unsigned int DiskDevice::CompleteDevOp()
 			blkOfs = (diskOfs + ((currCyl * diskP->getHeadNum() * diskP->getSectNum()) +
 			                     (head * diskP->getSectNum()) + sect) * BLOCKSIZE) * WORDLEN;
 
-			if (cylBuf != MAXWORDVAL || !diskBuf->ReadBlock(diskFile, blkOfs)) {
+			if (cylBuf != MAXWORDVAL ||
+			    (cacheTracks > 0 ? !cacheRead(head, sect) : !diskBuf->ReadBlock(diskFile, blkOfs))) {
 				// Wanted sector is already in buffer or has been read correctly
 				cylBuf = currCyl;
 				headBuf = head;
@@ -1103,6 +1401,7 @@ unsigned int DiskDevice::CompleteDevOp()
 					        currCyl, head, sect);
 				} else {
 					// all ok
+					stats.dmaBytes += BLOCKSIZE * WORDLEN;
 					sprintf(statStr, "C/H/S 0x%.4X/0x%.2X/0x%.2X block read: waiting for ACK",
 					        currCyl, head, sect);
 					reg[STATUS] = READY;
@@ -1135,7 +1434,9 @@ unsigned int DiskDevice::CompleteDevOp()
 				sprintf(strbuf, "Unable to write disk %u file : invalid/corrupted file", devNum);
 				Panic(strbuf);
 			}
-			// else all is ok: buffer is still valid
+			// else all is ok: buffer is still valid, and so is the
+			// track cache once updated
+			cacheUpdate(head, sect);
 			sprintf(statStr, "C/H/S 0x%.4X/0x%.2X/0x%.2X block written : waiting for ACK",
 			        currCyl, head, sect);
 			reg[STATUS] = READY;
@@ -1158,6 +1459,82 @@ unsigned int DiskDevice::CompleteDevOp()
 	return STATUS;
 }
 
+// This method returns the track cache slot holding track (cyl, head),
+// or cacheTracks if the track is not cached
+unsigned int DiskDevice::cacheLookup(unsigned int cyl, unsigned int head)
+{
+	unsigned int slot;
+
+	for (slot = 0; slot < cacheTracks; slot++)
+		if (cacheSlot[slot].cyl == cyl && cacheSlot[slot].head == head)
+			break;
+	return slot;
+}
+
+// This method fills the sector buffer with sector (currCyl, head, sect)
+// through the track cache: on a miss the whole track is read from file
+// into the least recently used slot, and read-ahead timing starts from
+// the wanted sector. Returns TRUE if file read does not succeed, FALSE
+// otherwise
+bool DiskDevice::cacheRead(unsigned int head, unsigned int sect)
+{
+	unsigned int sectNum = diskP->getSectNum();
+	unsigned int slot = cacheLookup(currCyl, head);
+	uint64_t now = bus->getToD();
+	SWord trkOfs;
+
+	if (slot == cacheTracks || cacheReady[slot * sectNum + sect] == SECTNOTREADY) {
+		if (slot == cacheTracks) {
+			// track replacement
+			slot = 0;
+			for (unsigned int i = 1; i < cacheTracks; i++)
+				if (cacheSlot[i].lastUse < cacheSlot[slot].lastUse)
+					slot = i;
+		}
+
+		trkOfs = (diskOfs + ((currCyl * diskP->getHeadNum() * sectNum) +
+		                     (head * sectNum)) * BLOCKSIZE) * WORDLEN;
+		if (Block::ReadBlocks(cacheBuf + slot * sectNum, sectNum, diskFile, trkOfs)) {
+			cacheSlot[slot].cyl = cacheSlot[slot].head = MAXWORDVAL;
+			return true;
+		}
+		cacheSlot[slot].cyl = currCyl;
+		cacheSlot[slot].head = head;
+
+		// wanted sector has been read just before DMA transfer: the
+		// following ones pass under the head one after another
+		for (unsigned int i = 0; i < sectNum; i++)
+			cacheReady[slot * sectNum + (sect + i) % sectNum] = (now - DMATICKS) + i * sectTicks;
+	}
+
+	cacheSlot[slot].lastUse = now;
+	*diskBuf = cacheBuf[slot * sectNum + sect];
+	return false;
+}
+
+// This method copies the sector buffer just written to sector
+// (currCyl, head, sect) into the track cache, if the track is cached
+void DiskDevice::cacheUpdate(unsigned int head, unsigned int sect)
+{
+	unsigned int slot = cacheLookup(currCyl, head);
+
+	if (slot < cacheTracks) {
+		cacheBuf[slot * diskP->getSectNum() + sect] = *diskBuf;
+		cacheReady[slot * diskP->getSectNum() + sect] = bus->getToD();
+	}
+}
+
+// This method stops read-ahead in progress: cached sectors which have
+// not yet passed under the head will not be available
+void DiskDevice::abortReadAhead()
+{
+	uint64_t now = bus->getToD();
+
+	for (unsigned int i = 0; i < cacheTracks * diskP->getSectNum(); i++)
+		if (cacheReady[i] != SECTNOTREADY && cacheReady[i] > now)
+			cacheReady[i] = SECTNOTREADY;
+}
+
 
 // FlashDevice class allows to emulate a flash drive: each 4096 byte block
 // is identified by one flash device coordinate;
@@ -1290,6 +1667,7 @@ void FlashDevice::WriteDevReg(unsigned int regnum, Word data)
 					blockBuf = MAXWORDVAL;
 					timeOfs = DMATICKS;
 				} else {
+					stats.dmaBytes += BLOCKSIZE * WORDLEN;
 					// flash device block in buffer from memory
 					blockBuf = block;
 
@@ -1364,6 +1742,7 @@ unsigned int FlashDevice::CompleteDevOp()
 					sprintf(statStr, "DMA error reading block 0x%.6X : waiting for ACK", block);
 				} else {
 					// all ok
+					stats.dmaBytes += BLOCKSIZE * WORDLEN;
 					sprintf(statStr, "Block 0x%.6X read: waiting for ACK", block);
 					reg[STATUS] = READY;
 				}
@@ -1421,31 +1800,49 @@ unsigned int FlashDevice::CompleteDevOp()
 // has been successful or not
 HIDDEN const char * isSuccess(unsigned int devType, Word regVal)
 {
-	const char * result = NULL;
+	return opResult[!opFailed(devType, regVal)];
+}
+
+// This function tells if the STATUS field holds an error code
+HIDDEN bool opFailed(unsigned int devType, Word regVal)
+{
+	bool failed = false;
 
 	switch (devType) {
 	case PRNTDEV:
 	case DISKDEV:
 	case FLASHDEV:
 	case ETHDEV:
-		if (regVal == READY)
-			result = opResult[true];
-		else
-			result = opResult[false];
+		failed = (regVal != READY);
 		break;
 
 	case TERMDEV:
-		if (regVal == READY || regVal == RECVD || regVal == TRANSMD)
-			result = opResult[true];
-		else
-			result = opResult[false];
+		failed = !(regVal == READY || regVal == RECVD || regVal == TRANSMD);
 		break;
 
 	default:
 		Panic("Unknown device in device module::isSuccess()");
 		break;
 	}
-	return(result);
+	return(failed);
+}
+
+// This function sets up log file buffering according to the given policy
+HIDDEN void setupOutput(FILE * file, unsigned int policy)
+{
+	switch (policy) {
+	case OUTPUT_UNBUFFERED:
+		setvbuf(file, (char *) NULL, _IONBF, 0);
+		break;
+
+	case OUTPUT_LINE_BUFFERED:
+		setvbuf(file, (char *) NULL, _IOLBF, OUTBUFSIZE);
+		break;
+
+	default:
+		setvbuf(file, (char *) NULL, _IOFBF, OUTBUFSIZE);
+		break;
+	}
 }
 
 
@@ -1460,7 +1857,6 @@ EthDevice::EthDevice(SystemBus* bus, const MachineConfig* cfg, unsigned int line
 	isWorking = true;
 	reg[STATUS] = READY;
 
-	readbuf = new Block();
 	writebuf = new Block();
 	sprintf(statStr, "Idle");
 
@@ -1471,19 +1867,18 @@ EthDevice::EthDevice(SystemBus* bus, const MachineConfig* cfg, unsigned int line
 	/* open the net */
 	netint = new netinterface(config->getDeviceFile(intL, devNum).c_str(),
 	                          (const char*) config->getMACId(devNum),
-	                          devNum);
-	if (netint->getmode() & INTERRUPT) {
-		scheduleIOEvent(POLLNETTIME * config->getClockRate());
-		polling = true;
-	} else {
-		polling = false;
-	}
+	                          devNum,
+	                          config->getLinkLatency(devNum),
+	                          config->getLinkBandwidth(devNum));
+	// in interrupt mode, wait for packets to come
+	polling = false;
+	if (netint->getmode() & INTERRUPT)
+		bus->WatchHostInput(this);
 }
 
 EthDevice::~EthDevice()
 {
 	delete netint;
-	delete readbuf;
 	delete writebuf;
 }
 
@@ -1536,6 +1931,7 @@ void EthDevice::WriteDevReg(unsigned int regnum, Word data)
 					sprintf(statStr, "DMA error on netwrite: waiting for ACK");
 					err=1;
 				} else {
+					stats.dmaBytes += reg[DATA1];
 					complTime = scheduleIOEvent(WRITENETTIME * config->getClockRate());
 					reg[STATUS] = BUSY;
 					sprintf(statStr, "Sending Data");
@@ -1588,12 +1984,10 @@ unsigned int EthDevice::CompleteDevOp()
 				SignalStatusChanged(getDevSStr());
 				bus->IntReq(intL, devNum);
 			} else {
-				/* there are no waiting packets;
-				   continue polling if the user hasn't changed her mind */
-				if (netint->getmode() & INTERRUPT) {
-					scheduleIOEvent(POLLNETTIME * config->getClockRate());
-					polling = true;
-				}
+				/* there are no waiting packets (any more);
+				   keep waiting if the user hasn't changed her mind */
+				if (netint->getmode() & INTERRUPT)
+					bus->WatchHostInput(this);
 			}
 		}
 	} else {
@@ -1638,20 +2032,25 @@ unsigned int EthDevice::CompleteDevOp()
 		case READNET:
 			if (isWorking)
 			{
-				if ((reg[DATA1]=netint->readdata((char *) readbuf, PACKETSIZE)) < 0) {
-					sprintf(statStr, "Net reading error: waiting for ACK");
-					reg[STATUS] = DREADERR;
-				} else if (reg[DATA1] == 0) {
+				// the packet is DMA'd to memory straight from the
+				// receive queue
+				unsigned int len;
+				const Word *packet = netint->peekdata(&len);
+				if (packet == NULL) {
+					reg[DATA1] = 0;
 					sprintf(statStr, "No pending packet for read: waiting for ACK");
 					reg[STATUS] = READY;
 				} else {
-					if (bus->DMAVarTransfer(readbuf, reg[DATA0], reg[DATA1], true)) {
+					reg[DATA1] = (len < PACKETSIZE) ? len : PACKETSIZE;
+					if (bus->DMAVarTransfer(packet, reg[DATA0], reg[DATA1])) {
 						reg[STATUS] = FDMAERR;
 						sprintf(statStr, "DMA error on netread: waiting for ACK");
 					} else {
+						stats.dmaBytes += reg[DATA1];
 						sprintf(statStr, "Packet received: waiting for ACK");
 						reg[STATUS] = READY;
 					}
+					netint->dropdata();
 				}
 				rp=netint->polling();
 			}
@@ -1690,18 +2089,36 @@ unsigned int EthDevice::CompleteDevOp()
 		bus->IntReq(intL, devNum);
 
 		// If user wants interrupts, we are not already polling, and
-		// there are no pending read requests, schedule another poll
-		// event.
-		if (netint->getmode() & INTERRUPT && !polling && !rp) {
-			scheduleIOEvent(POLLNETTIME * config->getClockRate());
-			polling = true;
-		}
+		// there are no pending read requests, wait for packets.
+		if (netint->getmode() & INTERRUPT && !polling && !rp)
+			bus->WatchHostInput(this);
 	}
 
 	return STATUS;
 }
 
+bool EthDevice::PollHostInput()
+{
+	if (polling || !(netint->getmode() & INTERRUPT) || (reg[STATUS] & READPENDING))
+		// nothing to wait for
+		return false;
+
+	if (!netint->polling())
+		return true;
+
+	// packets have come: interrupt the guest through the event queue
+	scheduleIOEvent(POLLNETTIME * config->getClockRate());
+	polling = true;
+	return false;
+}
+
 bool EthDevice::isBusy() const
 {
 	return (reg[STATUS] & READPENDINGMASK) == BUSY;
 }
+
+Word EthDevice::getUnitStatus(unsigned int unit) const
+{
+	UNUSED_ARG(unit);
+	return reg[STATUS] & READPENDINGMASK;
+}
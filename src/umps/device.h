@@ -24,6 +24,7 @@
 
 #include "umps/types.h"
 #include "umps/const.h"
+#include "umps/irq_latency.h"
 
 #include <sigc++/sigc++.h>
 
@@ -39,6 +40,7 @@ enum DeviceType {
 
 #define PRNTBUFSIZE 128
 #define TERMBUFSIZE 128
+#define TERMRECVBUFSIZE 65536
 #define DISKBUFSIZE 128
 #define FLASHBUFSIZE 128
 #define ETHBUFSIZE 128
@@ -50,6 +52,28 @@ class FlashParams;
 class netinterface;
 class MachineConfig;
 
+// I/O counters of a device, all of its sub-devices together
+struct DeviceStats {
+	DeviceStats()
+		: commands(0), errors(0), dmaBytes(0),
+		  busyCycles(0), queueCycles(0), queueWaits(0) {}
+
+// operations started, and those ending with an error status
+	uint64_t commands;
+	uint64_t errors;
+
+// bytes moved between memory and device
+	uint64_t dmaBytes;
+
+// time spent BUSY
+	uint64_t busyCycles;
+
+// time completed operations waited for the driver to take them, with
+// an ACK or the next command, and the number of such waits
+	uint64_t queueCycles;
+	uint64_t queueWaits;
+};
+
 // Device class defines the interface to all device types, and represents
 // the "uninstalled device" (NULLDEV) itself. Device objects are created and
 // controlled by a SystemBus object, but also may be inspected by Watch if
@@ -103,6 +127,35 @@ public:
 // devices (NULLDEV included) and produces a panic message
 	virtual void Input(const char* inputstr);
 
+// This method writes out any output buffered by the device (see
+// OutputBuffering): there is nothing to do for devices other than
+// printers and terminals
+	virtual void FlushOutput();
+
+// This method is invoked by SystemBus for devices parked waiting for
+// input from a host source (see SystemBus::WatchHostInput()): it checks
+// for input without blocking, and schedules the pending operation
+// completion if some has arrived. Returns TRUE if the device keeps
+// waiting, FALSE otherwise
+	virtual bool PollHostInput();
+
+// This method returns a bitmap of the sub-devices busy performing an
+// operation: devices other than terminals have just one
+	unsigned int getBusyUnits() const;
+
+// This method returns the I/O counters of the device
+	const DeviceStats& getStats() const {
+		return stats;
+	}
+
+// This method returns the number of operations in progress or completed
+// but not taken by the driver yet
+	unsigned int getQueueDepth() const;
+
+// This method is invoked by SystemBus after writing into device register
+// regnum, to count commands and the time completed operations waited for
+	void AccountRegWrite(unsigned int regnum);
+
 // This method returns the current value for device register field
 // indexed by regnum
 	Word ReadDevReg(unsigned int regnum);
@@ -129,6 +182,17 @@ public:
 protected:
 	virtual bool isBusy() const;
 	uint64_t scheduleIOEvent(uint64_t delay);
+	void completeIOEvent();
+
+// Printers and terminals call this when they put a character in their
+// log file buffer: the buffer gets flushed delay cycles later, unless
+// a flush is scheduled already, so that no output is held longer
+	void scheduleOutputFlush(uint64_t delay);
+
+// Sub-devices (each one with a status and a command register, in this
+// order) and the status code of each
+	virtual unsigned int getNumUnits() const;
+	virtual Word getUnitStatus(unsigned int unit) const;
 
 // Interrupt line and device number
 	unsigned int intL;
@@ -148,6 +212,24 @@ protected:
 
 // device operational status
 	bool isWorking;
+
+// I/O counters
+	DeviceStats stats;
+
+private:
+	static const unsigned int kMaxUnits = 2;
+
+	struct UnitState {
+		bool busy;
+		uint64_t busySince;
+		// completed operation not taken by the driver yet
+		bool done;
+		uint64_t doneAt;
+	};
+	UnitState units[kMaxUnits];
+
+	bool outputFlushScheduled;
+	void outputFlushEvent();
 };
 
 
@@ -161,7 +243,7 @@ protected:
 // It adds to Device data structure:
 // a pointer to SetupInfo object containing printer log file name;
 // a static buffer for device operation & status description;
-// a FILE structure for log file access.
+// a FILE structure for log file access, buffered as configured.
 
 class PrinterDevice: public Device {
 public:
@@ -170,12 +252,14 @@ public:
 	virtual void WriteDevReg(unsigned int regnum, Word data);
 	virtual unsigned int CompleteDevOp();
 	virtual const char* getDevSStr();
+	virtual void FlushOutput();
 
 private:
 	const MachineConfig* const config;
 
 // log file handling
 	FILE * prntFile;
+	unsigned int outBuffering;
 
 	char statStr[PRNTBUFSIZE];
 };
@@ -192,7 +276,8 @@ private:
 // It adds to Device data structure:
 // a pointer to SetupInfo object containing terminal log file name;
 // a static buffer for device operation & status description;
-// a FILE structure for log file access;
+// a FILE structure for log file access, buffered as configured;
+// an optional host input source (file, FIFO or pty) feeding the receiver;
 // some structures for handling terminal transmitter and receiver.
 
 class TerminalDevice: public Device {
@@ -212,18 +297,35 @@ public:
 	virtual std::string getCTimeInfo() const;
 
 	virtual void Input(const char * inputstr);
+	virtual void FlushOutput();
+	virtual bool PollHostInput();
 
 	sigc::signal<void, char> SignalTransmitted;
 
+protected:
+	virtual unsigned int getNumUnits() const;
+	virtual Word getUnitStatus(unsigned int unit) const;
+
 private:
 	const MachineConfig* const config;
 
 // for log file handling
 	FILE * termFile;
+	unsigned int outBuffering;
+
+// receiver ring buffer: recvCount characters, the first of which
+// is at recvHead
+	unsigned char recvBuf[TERMRECVBUFSIZE];
+	unsigned int recvHead;
+	unsigned int recvCount;
 
-// receiver buffer and pointer to first character to receive from it
-	char * recvBuf;
-	unsigned int recvBp;
+// host input source descriptor (-1 if none)
+	int inputFd;
+
+	void recvPut(const unsigned char * data, unsigned int len);
+	void readInput();
+	void recvPark();
+	void recvWake();
 
 // static buffer for receiver
 	char recvStatStr[TERMBUFSIZE];
@@ -237,6 +339,9 @@ private:
 // Completion time for current transmitter operation (if any)
 	uint64_t tranCTime;
 
+// receiver waiting for input (RECVCHR with no event scheduled)
+	bool recvParked;
+
 // receiver operation pending flag
 	bool recvIntPend;
 
@@ -252,7 +357,8 @@ private:
 // is identified by (cyl, head, sect) set of disk coordinates;
 // (geometry and performance figures are loaded from disk image file).
 // Operations on sectors (R/W) require previous seek on the desired cylinder.
-// It also contains a sector buffer of one sector to speed up operations.
+// It also contains a sector buffer of one sector to speed up operations,
+// and optionally a cache of whole tracks filled by read-ahead.
 //
 // It uses the same interface as Device, redefining only a few methods'
 // implementation: refer to it for individual methods descriptions.
@@ -263,6 +369,7 @@ private:
 // a FILE structure for disk image file access;
 // a set of disk parameters (read from disk image file header);
 // a Block object for file handling;
+// a track cache with its hit/miss counters;
 // some items for performance computation.
 
 class DiskDevice: public Device {
@@ -273,6 +380,26 @@ public:
 	virtual unsigned int CompleteDevOp();
 	virtual const char * getDevSStr();
 
+// These methods return the number of sector reads served from the sector
+// buffer or the track cache, and the number of those which required
+// access to the disk surface
+	uint64_t getCacheHits() const {
+		return cacheHits;
+	}
+	uint64_t getCacheMisses() const {
+		return cacheMisses;
+	}
+
+// These methods return the distributions of seek distances (in
+// cylinders) and of the rotational latency of sector reads and writes
+// reaching the disk surface (in cycles)
+	const LatencyHistogram& getSeekDistances() const {
+		return seekDistances;
+	}
+	const LatencyHistogram& getRotationalLatencies() const {
+		return rotLatencies;
+	}
+
 private:
 	const MachineConfig* const config;
 
@@ -297,6 +424,27 @@ private:
 
 // current cylinder
 	unsigned int currCyl;
+
+// track cache: each of cacheTracks slots holds a whole track in cacheBuf;
+// for each sector in it cacheReady tells when read-ahead makes its data
+// available (NOTREADY if it never will)
+	struct TrackSlot {
+		unsigned int cyl, head;
+		uint64_t lastUse;
+	};
+	unsigned int cacheTracks;
+	TrackSlot * cacheSlot;
+	Block * cacheBuf;
+	uint64_t * cacheReady;
+	uint64_t cacheHits, cacheMisses;
+
+	LatencyHistogram seekDistances;
+	LatencyHistogram rotLatencies;
+
+	unsigned int cacheLookup(unsigned int cyl, unsigned int head);
+	bool cacheRead(unsigned int head, unsigned int sect);
+	void cacheUpdate(unsigned int head, unsigned int sect);
+	void abortReadAhead();
 };
 
 
@@ -359,14 +507,15 @@ public:
 	virtual void WriteDevReg(unsigned int regnum, Word data);
 	virtual unsigned int CompleteDevOp();
 	virtual const char* getDevSStr();
+	virtual bool PollHostInput();
 
 protected:
 	virtual bool isBusy() const;
+	virtual Word getUnitStatus(unsigned int unit) const;
 
 private:
 	const MachineConfig* const config;
 
-	Block *readbuf;
 	Block *writebuf;
 
 // static buffer
@@ -0,0 +1,137 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/irq_latency.h"
+
+#include <string.h>
+
+#include "umps/const.h"
+
+LatencyHistogram::LatencyHistogram()
+	: count(0),
+	  sum(0),
+	  min(0),
+	  max(0)
+{
+	memset(buckets, 0, sizeof(buckets));
+}
+
+void LatencyHistogram::Add(uint64_t latency)
+{
+	if (count == 0 || latency < min)
+		min = latency;
+	if (latency > max)
+		max = latency;
+	count++;
+	sum += latency;
+
+	unsigned int i = 0;
+	while (i < kBuckets - 1 && (latency + 1) >> (i + 1))
+		i++;
+	buckets[i]++;
+}
+
+void LatencyHistogram::Write(FILE* file, const char* label) const
+{
+	if (count == 0)
+		return;
+
+	fprintf(file, "  %-10s n=%llu min=%llu avg=%.1f max=%llu\n", label,
+	        (unsigned long long) count, (unsigned long long) min,
+	        (double) sum / count, (unsigned long long) max);
+
+	unsigned int first = 0, last = kBuckets - 1;
+	while (buckets[first] == 0)
+		first++;
+	while (buckets[last] == 0)
+		last--;
+	for (unsigned int i = first; i <= last; i++)
+		fprintf(file, "    < %-12llu %llu\n",
+		        (unsigned long long) ((uint64_t(2) << i) - 1), (unsigned long long) buckets[i]);
+}
+
+InterruptLatency::Source::Source()
+	: pending(false),
+	  taken(false),
+	  target(0),
+	  start(0)
+{
+}
+
+InterruptLatency::InterruptLatency()
+{
+}
+
+void InterruptLatency::Request(unsigned int il, unsigned int devNo, Word cpu, uint64_t time)
+{
+	Source& s = sources[il - IL_TIMER][devNo];
+
+	// A request raised again before the ack is still the same one
+	if (s.pending)
+		return;
+
+	s.pending = true;
+	s.taken = false;
+	s.target = cpu;
+	s.start = time;
+}
+
+void InterruptLatency::Taken(Word cpu, Word lines, uint64_t time)
+{
+	for (unsigned int il = IL_TIMER; il < IL_TIMER + kNumLines; il++) {
+		if (!(lines & (1U << il)))
+			continue;
+		for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++) {
+			Source& s = sources[il - IL_TIMER][devNo];
+			if (s.pending && !s.taken && s.target == cpu) {
+				s.taken = true;
+				s.entry.Add(time - s.start);
+			}
+		}
+	}
+}
+
+void InterruptLatency::Ack(unsigned int il, unsigned int devNo, uint64_t time)
+{
+	Source& s = sources[il - IL_TIMER][devNo];
+
+	if (s.pending) {
+		s.pending = false;
+		s.ack.Add(time - s.start);
+	}
+}
+
+void InterruptLatency::WriteReport(FILE* file) const
+{
+	for (unsigned int il = IL_TIMER; il < IL_TIMER + kNumLines; il++) {
+		for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++) {
+			const Source& s = sources[il - IL_TIMER][devNo];
+			if (s.entry.count == 0 && s.ack.count == 0)
+				continue;
+			if (il == IL_TIMER)
+				fprintf(file, "Interval timer (line %u)\n", il);
+			else
+				fprintf(file, "Line %u, device %u\n", il, devNo);
+			s.entry.Write(file, "to handler");
+			s.ack.Write(file, "to ack");
+		}
+	}
+}
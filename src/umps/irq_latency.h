@@ -0,0 +1,100 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_IRQ_LATENCY_H
+#define UMPS_IRQ_LATENCY_H
+
+#include <stdio.h>
+
+#include "base/lang.h"
+#include "umps/arch.h"
+#include "umps/types.h"
+
+// A latency distribution, in cycles (or another quantity, such as
+// seek distances), with power-of-two buckets: bucket i counts values
+// in [2^i - 1, 2^(i+1) - 1)
+struct LatencyHistogram {
+	static const unsigned int kBuckets = 32;
+
+	LatencyHistogram();
+	void Add(uint64_t latency);
+
+	// Print a summary line headed by label, then the count of each
+	// bucket from the first to the last non-empty one
+	void Write(FILE* file, const char* label) const;
+
+	uint64_t count;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
+	uint64_t buckets[kBuckets];
+};
+
+/*
+ * InterruptLatency measures, for each interrupt source (interval
+ * timer and devices), the cycles from the interrupt request raised by
+ * InterruptController::StartIRQ to the target cpu entering the
+ * interrupt exception (entry latency), and to the acknowledgment
+ * ending the request (ack latency).
+ */
+class InterruptLatency {
+public:
+	InterruptLatency();
+
+	void Request(unsigned int il, unsigned int devNo, Word cpu, uint64_t time);
+	// Interrupt exception taken by cpu for lines (a bitmap of
+	// interrupt lines, as in CAUSE.IP)
+	void Taken(Word cpu, Word lines, uint64_t time);
+	void Ack(unsigned int il, unsigned int devNo, uint64_t time);
+
+	// Histograms of a source: il from IL_TIMER to the last device line
+	const LatencyHistogram& getEntryLatency(unsigned int il, unsigned int devNo) const {
+		return sources[il - IL_TIMER][devNo].entry;
+	}
+	const LatencyHistogram& getAckLatency(unsigned int il, unsigned int devNo) const {
+		return sources[il - IL_TIMER][devNo].ack;
+	}
+
+	// Print histograms of all sources that interrupted
+	void WriteReport(FILE* file) const;
+
+private:
+	struct Source {
+		Source();
+
+		// Pending request: when it was raised and where it went
+		bool pending;
+		bool taken;
+		Word target;
+		uint64_t start;
+
+		LatencyHistogram entry;
+		LatencyHistogram ack;
+	};
+
+	static const unsigned int kNumLines = N_EXT_IL + 1;
+
+	Source sources[kNumLines][N_DEV_PER_IL];
+
+	DISABLE_COPY_AND_ASSIGNMENT(InterruptLatency);
+};
+
+#endif // UMPS_IRQ_LATENCY_H
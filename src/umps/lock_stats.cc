@@ -0,0 +1,107 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/lock_stats.h"
+
+#include <algorithm>
+
+#include "umps/const.h"
+#include "umps/symbol_table.h"
+
+LockStats::LockStats(unsigned int numCpus)
+	: numCpus(numCpus),
+	  spins(new Spin[numCpus])
+{
+	Reset();
+}
+
+void LockStats::CompareAndSet(Word paddr, bool success, Word cpu, uint64_t time)
+{
+	Lock& lock = locks[paddr];
+	lock.addr = paddr;
+	lock.attempts++;
+
+	Spin& s = spins[cpu];
+	if (!success) {
+		lock.failures++;
+		if (!s.spinning || s.addr != paddr) {
+			s.spinning = true;
+			s.addr = paddr;
+			s.start = time;
+		}
+	} else if (s.spinning && s.addr == paddr) {
+		uint64_t spin = time - s.start;
+		lock.contended++;
+		lock.spinCycles += spin;
+		lock.maxSpin = std::max(lock.maxSpin, spin);
+		s.spinning = false;
+	}
+}
+
+std::vector<LockStats::Lock> LockStats::getTopLocks(size_t n) const
+{
+	std::vector<Lock> top;
+	top.reserve(locks.size());
+	for (const auto& l : locks)
+		top.push_back(l.second);
+
+	n = std::min(n, top.size());
+	std::partial_sort(top.begin(), top.begin() + n, top.end(),
+	                  [](const Lock& a, const Lock& b) {
+		                  if (a.spinCycles != b.spinCycles)
+			                  return a.spinCycles > b.spinCycles;
+		                  return a.failures > b.failures;
+	                  });
+	top.resize(n);
+	return top;
+}
+
+// Kernel code runs unmapped, so that physical addresses of kernel
+// objects are the ones in the kernel symbol table
+void LockStats::WriteReport(FILE* file, const SymbolTable* stab, size_t n) const
+{
+	fprintf(file, "%-10s %-28s %12s %12s %10s %14s %10s\n", "Address", "Symbol",
+	        "Attempts", "Failures", "Contended", "Spin cycles", "Max spin");
+
+	for (const Lock& l : getTopLocks(n)) {
+		char symStr[64] = "";
+		const char* sym = NULL;
+		SWord offset = 0;
+		if (stab != NULL)
+			sym = stab->Probe(MAXASID, l.addr, true, &offset);
+		if (sym != NULL && offset != 0)
+			snprintf(symStr, sizeof(symStr), "%s+0x%X", sym, (unsigned int) offset);
+		else if (sym != NULL)
+			snprintf(symStr, sizeof(symStr), "%s", sym);
+
+		fprintf(file, "0x%.8X %-28s %12llu %12llu %10llu %14llu %10llu\n", l.addr, symStr,
+		        (unsigned long long) l.attempts, (unsigned long long) l.failures,
+		        (unsigned long long) l.contended, (unsigned long long) l.spinCycles,
+		        (unsigned long long) l.maxSpin);
+	}
+}
+
+void LockStats::Reset()
+{
+	locks.clear();
+	for (unsigned int i = 0; i < numCpus; i++)
+		spins[i].spinning = false;
+}
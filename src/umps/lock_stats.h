@@ -0,0 +1,84 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_LOCK_STATS_H
+#define UMPS_LOCK_STATS_H
+
+#include <stdio.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "base/lang.h"
+#include "umps/types.h"
+
+class SymbolTable;
+
+/*
+ * LockStats profiles lock contention from the outcome of CAS
+ * instructions, by physical address: attempts, failures, and the
+ * cycles each cpu spends spinning on a location, from the first
+ * failed CAS to the next successful one. A cpu spins on one location
+ * at a time; failing on another one restarts the count there.
+ */
+class LockStats {
+public:
+	struct Lock {
+		Word addr;
+		uint64_t attempts;
+		uint64_t failures;
+		// Successful CAS preceded by failures, and the cycles spent
+		// spinning before them
+		uint64_t contended;
+		uint64_t spinCycles;
+		uint64_t maxSpin;
+	};
+
+	LockStats(unsigned int numCpus);
+
+	// Count a CAS executed by cpu on paddr at the given time
+	void CompareAndSet(Word paddr, bool success, Word cpu, uint64_t time);
+
+	// The n locks with most spin cycles (then failures), hottest first
+	std::vector<Lock> getTopLocks(size_t n) const;
+
+	// Print the n hottest locks, named after the kernel objects holding
+	// them if stab (which may be NULL) is a kernel symbol table
+	void WriteReport(FILE* file, const SymbolTable* stab, size_t n) const;
+
+	void Reset();
+
+private:
+	struct Spin {
+		bool spinning;
+		Word addr;
+		uint64_t start;
+	};
+
+	const unsigned int numCpus;
+
+	std::unordered_map<Word, Lock> locks;
+	scoped_array<Spin> spins;
+
+	DISABLE_COPY_AND_ASSIGNMENT(LockStats);
+};
+
+#endif // UMPS_LOCK_STATS_H
@@ -31,6 +31,18 @@
 #include "umps/machine_config.h"
 #include "umps/stoppoint.h"
 #include "umps/systembus.h"
+#include "umps/device.h"
+#include "umps/trace_recorder.h"
+#include "umps/sampling_profiler.h"
+#include "umps/callgraph_profiler.h"
+#include "umps/timeline_recorder.h"
+#include "umps/code_coverage.h"
+#include "umps/memory_heatmap.h"
+#include "umps/cache_model.h"
+#include "umps/tlb_stats.h"
+#include "umps/irq_latency.h"
+#include "umps/lock_stats.h"
+#include "umps/metrics_stream.h"
 
 Machine::Machine(const MachineConfig* config,
                  StoppointSet* breakpoints,
@@ -39,6 +51,7 @@ Machine::Machine(const MachineConfig* config,
 	: stopMask(0),
 	config(config),
 	halted(false),
+	stoppointHits(0),
 	breakpoints(breakpoints),
 	suspects(suspects),
 	tracepoints(tracepoints)
@@ -47,6 +60,35 @@ Machine::Machine(const MachineConfig* config,
 
 	bus.reset(new SystemBus(config, this));
 
+	if (!config->getTraceFile().empty())
+		tracer.reset(new TraceRecorder(config));
+	if (!config->getSamplingFile().empty())
+		profiler.reset(new SamplingProfiler(config, this));
+	if (!config->getCallGraphFile().empty())
+		callGraph.reset(new CallGraphProfiler(config, this));
+	if (!config->getTimelineFile().empty()) {
+		timeline.reset(new TimelineRecorder(config, this));
+		bus->setTimeline(timeline.get());
+	}
+	if (!config->getCoverageFile().empty()) {
+		coverage.reset(new CodeCoverage(config));
+		bus->setCoverage(coverage.get());
+	}
+	if (config->isHeatmapEnabled()) {
+		heatmap.reset(new MemoryHeatmap(config));
+		bus->setHeatmap(heatmap.get());
+	}
+	if (config->isCacheModelEnabled()) {
+		caches.reset(new CacheModel(config));
+		bus->setCaches(caches.get());
+	}
+	// TLB, interrupt and CAS events are rare enough to be always counted
+	tlbStats.reset(new TLBStats);
+	irqLatency.reset(new InterruptLatency);
+	bus->setInterruptLatency(irqLatency.get());
+	lockStats.reset(new LockStats(config->getNumProcessors()));
+	bus->setLockStats(lockStats.get());
+
 	for (unsigned int i = 0; i < config->getNumProcessors(); i++) {
 		Processor* cpu = new Processor(config, i, this, bus.get());
 		cpu->SignalException.connect(
@@ -55,15 +97,27 @@ Machine::Machine(const MachineConfig* config,
 		cpu->StatusChanged.connect(
 			sigc::bind(sigc::mem_fun(this, &Machine::onCpuStatusChanged), cpu)
 			);
+		cpu->setTracer(tracer.get());
+		cpu->setCallGraphProfiler(callGraph.get());
+		cpu->setTimeline(timeline.get());
+		cpu->setTLBStats(tlbStats.get());
+		cpu->setInterruptLatency(irqLatency.get());
 		pd[i].stopCause = 0;
 		cpus.push_back(cpu);
 	}
 
+	// Samples read the processors, so the stream comes after them
+	if (!config->getMetricsFile().empty())
+		metrics.reset(new MetricsStream(config, this));
+
 	cpus[0]->Reset(MCTL_DEFAULT_BOOT_PC, MCTL_DEFAULT_BOOT_SP);
 }
 
 Machine::~Machine()
 {
+	// The last sample is taken while the processors are still there
+	metrics.reset();
+
 	for (Processor* p : cpus)
 		delete p;
 }
@@ -74,6 +128,8 @@ void Machine::step(unsigned int steps, unsigned int* stepped, bool* stopped)
 	for (Processor* cpu : cpus)
 		pd[cpu->Id()].stopCause = 0;
 
+	bus->PollHostInput();
+
 	unsigned int i;
 	for (i = 0; !halted && i < steps && !stopRequested && !pauseRequested; ++i) {
 		bus->ClockTick();
@@ -84,6 +140,14 @@ void Machine::step(unsigned int steps, unsigned int* stepped, bool* stopped)
 		*stepped = i;
 	if (stopped)
 		*stopped = stopRequested;
+
+	// Output must not lag behind when the machine is about to stop
+	// or to become idle (e.g. waiting for input after a prompt)
+	if (halted || stopRequested || pauseRequested)
+		FlushOutput();
+
+	if (metrics != NULL)
+		metrics->Poll();
 }
 
 void Machine::step(bool* stopped)
@@ -114,6 +178,45 @@ void Machine::skip(uint32_t cycles)
 		if (!cpu->isHalted())
 			cpu->Skip(cycles);
 	}
+
+	// Host input is the only thing that can end an idle period early
+	bus->PollHostInput();
+
+	if (metrics != NULL)
+		metrics->Poll();
+}
+
+std::vector<Machine::CycleAccount> Machine::getCycleAccounts() const
+{
+	std::vector<CycleAccount> accounts;
+
+	for (Word asid = 0; asid < MAXASID; asid++) {
+		CycleAccount a = { asid, 0, 0 };
+		for (Processor* cpu : cpus) {
+			a.kernel += cpu->getModeCycles(asid, false);
+			a.user += cpu->getModeCycles(asid, true);
+		}
+		if (a.kernel + a.user > 0)
+			accounts.push_back(a);
+	}
+
+	return accounts;
+}
+
+uint64_t Machine::getIdleCycles() const
+{
+	uint64_t cycles = 0;
+	for (Processor* cpu : cpus)
+		cycles += cpu->getPerfCounter(PERF_IDLE_CYCLES);
+	return cycles;
+}
+
+uint64_t Machine::getHandlerCycles() const
+{
+	uint64_t cycles = 0;
+	for (Processor* cpu : cpus)
+		cycles += cpu->getHandlerCycles();
+	return cycles;
 }
 
 void Machine::Halt()
@@ -121,6 +224,13 @@ void Machine::Halt()
 	halted = true;
 }
 
+void Machine::FlushOutput()
+{
+	for (unsigned int il = 0; il < N_EXT_IL; il++)
+		for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++)
+			bus->getDev(il, devNo)->FlushOutput();
+}
+
 void Machine::onCpuException(unsigned int excCode, Processor* cpu)
 {
 	bool utlbExc = (excCode == UTLBLEXCEPTION || excCode == UTLBSEXCEPTION);
@@ -136,6 +246,10 @@ void Machine::onCpuException(unsigned int excCode, Processor* cpu)
 
 void Machine::onCpuStatusChanged(const Processor* cpu)
 {
+	bus->CpuStatusChanged(cpu);
+	if (timeline != NULL)
+		timeline->CpuStatus(cpu->getId(), cpu->getStatus());
+
 	// Whenever a cpu goes to sleep, give the client a chance to
 	// detect idle machine states.
 	if (cpu->isIdle())
@@ -156,6 +270,7 @@ void Machine::HandleBusAccess(Word pAddr, Word access, Processor* cpu)
 				pd[cpu->getId()].stopCause |= SC_SUSPECT;
 				pd[cpu->getId()].suspectId = suspect->getId();
 				stopRequested = true;
+				stoppointHits++;
 			}
 		}
 		break;
@@ -167,6 +282,7 @@ void Machine::HandleBusAccess(Word pAddr, Word access, Processor* cpu)
 				pd[cpu->getId()].stopCause |= SC_BREAKPOINT;
 				pd[cpu->getId()].breakpointId = breakpoint->getId();
 				stopRequested = true;
+				stoppointHits++;
 			}
 		}
 		break;
@@ -179,7 +295,8 @@ void Machine::HandleBusAccess(Word pAddr, Word access, Processor* cpu)
 	// Check for traced ranges
 	if (access == WRITE) {
 		Stoppoint* tracepoint = tracepoints->Probe(MAXASID, pAddr, AM_WRITE, cpu);
-		(void) tracepoint;
+		if (tracepoint != NULL)
+			stoppointHits++;
 	}
 }
 
@@ -196,6 +313,7 @@ void Machine::HandleVMAccess(Word asid, Word vaddr, Word access, Processor* cpu)
 				pd[cpu->Id()].stopCause |= SC_SUSPECT;
 				pd[cpu->Id()].suspectId = suspect->getId();
 				stopRequested = true;
+				stoppointHits++;
 			}
 		}
 		break;
@@ -207,6 +325,7 @@ void Machine::HandleVMAccess(Word asid, Word vaddr, Word access, Processor* cpu)
 				pd[cpu->Id()].stopCause |= SC_BREAKPOINT;
 				pd[cpu->Id()].breakpointId = breakpoint->getId();
 				stopRequested = true;
+				stoppointHits++;
 			}
 		}
 		break;
@@ -39,6 +39,17 @@ class Processor;
 class SystemBus;
 class Device;
 class StoppointSet;
+class TraceRecorder;
+class SamplingProfiler;
+class CallGraphProfiler;
+class TimelineRecorder;
+class CodeCoverage;
+class MemoryHeatmap;
+class CacheModel;
+class TLBStats;
+class InterruptLatency;
+class LockStats;
+class MetricsStream;
 
 class Machine {
 public:
@@ -59,10 +70,54 @@ public:
 		return halted;
 	}
 
+	// Write out output held by buffered devices (see OutputBuffering)
+	void FlushOutput();
+
 	Processor* getProcessor(unsigned int cpuId);
 	Device* getDevice(unsigned int line, unsigned int devNo);
 	SystemBus* getBus();
 
+	// Memory access counters, or NULL if not enabled
+	MemoryHeatmap* getHeatmap() {
+		return heatmap.get();
+	}
+
+	// Cycles run by an ASID in kernel and user mode, summed over
+	// all cpus; ASIDs that never ran are left out
+	struct CycleAccount {
+		Word asid;
+		uint64_t kernel;
+		uint64_t user;
+	};
+	std::vector<CycleAccount> getCycleAccounts() const;
+	uint64_t getIdleCycles() const;
+	uint64_t getHandlerCycles() const;
+
+	// TLB fault and write counters of all cpus
+	TLBStats* getTLBStats() {
+		return tlbStats.get();
+	}
+
+	// Interrupt latency histograms, by source
+	InterruptLatency* getInterruptLatency() {
+		return irqLatency.get();
+	}
+
+	// CAS contention counters, by lock address
+	LockStats* getLockStats() {
+		return lockStats.get();
+	}
+
+	// Simulated caches, or NULL if not enabled
+	CacheModel* getCaches() {
+		return caches.get();
+	}
+
+	// Breakpoint, suspect and tracepoint hits so far
+	uint64_t getStoppointHits() const {
+		return stoppointHits;
+	}
+
 	void setStopMask(unsigned int mask);
 	unsigned int getStopMask() const;
 
@@ -92,6 +147,18 @@ private:
 
 	scoped_ptr<SystemBus> bus;
 
+	scoped_ptr<TraceRecorder> tracer;
+	scoped_ptr<SamplingProfiler> profiler;
+	scoped_ptr<CallGraphProfiler> callGraph;
+	scoped_ptr<TimelineRecorder> timeline;
+	scoped_ptr<CodeCoverage> coverage;
+	scoped_ptr<MemoryHeatmap> heatmap;
+	scoped_ptr<CacheModel> caches;
+	scoped_ptr<TLBStats> tlbStats;
+	scoped_ptr<InterruptLatency> irqLatency;
+	scoped_ptr<LockStats> lockStats;
+	scoped_ptr<MetricsStream> metrics;
+
 	typedef std::vector<Processor*> CpuVector;
 	std::vector<Processor*> cpus;
 
@@ -101,6 +168,8 @@ private:
 	bool stopRequested;
 	bool pauseRequested;
 
+	uint64_t stoppointHits;
+
 	StoppointSet* breakpoints;
 	StoppointSet* suspects;
 	StoppointSet* tracepoints;
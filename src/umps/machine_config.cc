@@ -55,6 +55,40 @@ const char* const MachineConfig::deviceKeyPrefix[N_EXT_IL] = {
 	"terminal"
 };
 
+const char* const MachineConfig::outputBufferingName[N_OUTPUT_BUFFERING] = {
+	"none",
+	"line",
+	"full"
+};
+
+const char* const MachineConfig::traceModeName[N_TRACE_MODES] = {
+	"all",
+	"kernel",
+	"user"
+};
+
+const char* const MachineConfig::metricsFormatName[N_METRICS_FORMATS] = {
+	"json",
+	"csv"
+};
+
+const char* const MachineConfig::metricsClockName[N_METRICS_CLOCKS] = {
+	"host",
+	"guest"
+};
+
+const char* const MachineConfig::heatmapSplitName[N_HEATMAP_SPLITS] = {
+	"none",
+	"cpu",
+	"asid"
+};
+
+const char* const MachineConfig::cacheLevelKey[N_CACHE_LEVELS] = {
+	"l1i",
+	"l1d",
+	"l2"
+};
+
 MachineConfig* MachineConfig::LoadFromFile(const std::string& fileName, std::string& error)
 {
 	std::ifstream inputStream(fileName.c_str());
@@ -109,6 +143,98 @@ MachineConfig* MachineConfig::LoadFromFile(const std::string& fileName, std::str
 			config->setSymbolTableASID(stab->Get("asid")->AsNumber());
 		}
 
+		if (root->HasMember("trace")) {
+			JsonObject* trace = root->Get("trace")->AsObject();
+			config->setTraceFile(trace->Get("file")->AsString());
+			if (trace->HasMember("asid"))
+				config->setTraceASID(trace->Get("asid")->AsNumber());
+			if (trace->HasMember("start") && trace->HasMember("end"))
+				config->setTraceRange(stoul(trace->Get("start")->AsString().erase(0, 2), 0, 16),
+				                      stoul(trace->Get("end")->AsString().erase(0, 2), 0, 16));
+			if (trace->HasMember("mode")) {
+				const std::string& name = trace->Get("mode")->AsString();
+				for (unsigned int i = 0; i < N_TRACE_MODES; i++)
+					if (name == traceModeName[i])
+						config->setTraceMode((TraceMode) i);
+			}
+		}
+
+		if (root->HasMember("profile")) {
+			JsonObject* profile = root->Get("profile")->AsObject();
+			if (profile->HasMember("sampling-file"))
+				config->setSamplingFile(profile->Get("sampling-file")->AsString());
+			if (profile->HasMember("sampling-interval"))
+				config->setSamplingInterval(profile->Get("sampling-interval")->AsNumber());
+			if (profile->HasMember("callgraph-file"))
+				config->setCallGraphFile(profile->Get("callgraph-file")->AsString());
+		}
+
+		if (root->HasMember("timeline")) {
+			JsonObject* timeline = root->Get("timeline")->AsObject();
+			config->setTimelineFile(timeline->Get("file")->AsString());
+		}
+
+		if (root->HasMember("metrics")) {
+			JsonObject* metrics = root->Get("metrics")->AsObject();
+			config->setMetricsFile(metrics->Get("file")->AsString());
+			if (metrics->HasMember("format")) {
+				const std::string& name = metrics->Get("format")->AsString();
+				for (unsigned int i = 0; i < N_METRICS_FORMATS; i++)
+					if (name == metricsFormatName[i])
+						config->setMetricsFormat((MetricsFormat) i);
+			}
+			if (metrics->HasMember("interval"))
+				config->setMetricsInterval(metrics->Get("interval")->AsNumber());
+			if (metrics->HasMember("clock")) {
+				const std::string& name = metrics->Get("clock")->AsString();
+				for (unsigned int i = 0; i < N_METRICS_CLOCKS; i++)
+					if (name == metricsClockName[i])
+						config->setMetricsClock((MetricsClock) i);
+			}
+		}
+
+		if (root->HasMember("coverage")) {
+			JsonObject* coverage = root->Get("coverage")->AsObject();
+			config->setCoverageFile(coverage->Get("file")->AsString());
+			if (coverage->HasMember("merge"))
+				config->setCoverageMergeEnabled(coverage->Get("merge")->AsBool());
+		}
+
+		if (root->HasMember("heatmap")) {
+			JsonObject* heatmap = root->Get("heatmap")->AsObject();
+			config->setHeatmapEnabled(heatmap->Get("enabled")->AsBool());
+			if (heatmap->HasMember("file"))
+				config->setHeatmapFile(heatmap->Get("file")->AsString());
+			if (heatmap->HasMember("split")) {
+				const std::string& name = heatmap->Get("split")->AsString();
+				for (unsigned int i = 0; i < N_HEATMAP_SPLITS; i++)
+					if (name == heatmapSplitName[i])
+						config->setHeatmapSplit((HeatmapSplit) i);
+			}
+		}
+
+		if (root->HasMember("caches")) {
+			JsonObject* caches = root->Get("caches")->AsObject();
+			config->setCacheModelEnabled(caches->Get("enabled")->AsBool());
+			for (unsigned int i = 0; i < N_CACHE_LEVELS; i++) {
+				if (!caches->HasMember(cacheLevelKey[i]))
+					continue;
+				JsonObject* cache = caches->Get(cacheLevelKey[i])->AsObject();
+				if (cache->HasMember("size"))
+					config->setCacheSize((CacheLevel) i, cache->Get("size")->AsNumber());
+				if (cache->HasMember("ways"))
+					config->setCacheWays((CacheLevel) i, cache->Get("ways")->AsNumber());
+				if (cache->HasMember("line"))
+					config->setCacheLineSize((CacheLevel) i, cache->Get("line")->AsNumber());
+			}
+			if (caches->HasMember("l2-latency"))
+				config->setL2Latency(caches->Get("l2-latency")->AsNumber());
+			if (caches->HasMember("memory-latency"))
+				config->setMemoryLatency(caches->Get("memory-latency")->AsNumber());
+			if (caches->HasMember("stall"))
+				config->setCacheStallEnabled(caches->Get("stall")->AsBool());
+		}
+
 		if (root->HasMember("devices")) {
 			JsonObject* devices = root->Get("devices")->AsObject();
 			for (unsigned int il = 0; il < N_EXT_IL; il++) {
@@ -123,6 +249,20 @@ MachineConfig* MachineConfig::LoadFromFile(const std::string& fileName, std::str
 							if (ParseMACId(devObj->Get("address")->AsString(), macId))
 								config->setMACId(devNo, macId);
 						}
+						if (il == EXT_IL_INDEX(IL_ETHERNET) && devObj->HasMember("link-latency"))
+							config->setLinkLatency(devNo, devObj->Get("link-latency")->AsNumber());
+						if (il == EXT_IL_INDEX(IL_ETHERNET) && devObj->HasMember("link-bandwidth"))
+							config->setLinkBandwidth(devNo, devObj->Get("link-bandwidth")->AsNumber());
+						if (il == EXT_IL_INDEX(IL_DISK) && devObj->HasMember("cache-tracks"))
+							config->setDiskCacheTracks(devNo, devObj->Get("cache-tracks")->AsNumber());
+						if (il == EXT_IL_INDEX(IL_TERMINAL) && devObj->HasMember("input"))
+							config->setTerminalInput(devNo, devObj->Get("input")->AsString());
+						if (devObj->HasMember("output-buffering")) {
+							const std::string& name = devObj->Get("output-buffering")->AsString();
+							for (unsigned int i = 0; i < N_OUTPUT_BUFFERING; i++)
+								if (name == outputBufferingName[i])
+									config->setOutputBuffering(il, devNo, (OutputBuffering) i);
+						}
 					}
 				}
 			}
@@ -173,6 +313,73 @@ void MachineConfig::Save()
 	stabObject->Set("asid", (int) symbolTableASID);
 	root->Set("symbol-table", stabObject);
 
+	if (!traceFile.empty()) {
+		JsonObject* traceObject = new JsonObject;
+		traceObject->Set("file", traceFile);
+		traceObject->Set("asid", (int) traceASID);
+		traceObject->Set("start", IntToHexString(traceStart));
+		traceObject->Set("end", IntToHexString(traceEnd));
+		traceObject->Set("mode", traceModeName[traceMode]);
+		root->Set("trace", traceObject);
+	}
+
+	if (!samplingFile.empty() || !callGraphFile.empty()) {
+		JsonObject* profileObject = new JsonObject;
+		if (!samplingFile.empty()) {
+			profileObject->Set("sampling-file", samplingFile);
+			profileObject->Set("sampling-interval", (int) samplingInterval);
+		}
+		if (!callGraphFile.empty())
+			profileObject->Set("callgraph-file", callGraphFile);
+		root->Set("profile", profileObject);
+	}
+
+	if (!timelineFile.empty()) {
+		JsonObject* timelineObject = new JsonObject;
+		timelineObject->Set("file", timelineFile);
+		root->Set("timeline", timelineObject);
+	}
+
+	if (!metricsFile.empty()) {
+		JsonObject* metricsObject = new JsonObject;
+		metricsObject->Set("file", metricsFile);
+		metricsObject->Set("format", metricsFormatName[metricsFormat]);
+		metricsObject->Set("interval", (int) metricsInterval);
+		metricsObject->Set("clock", metricsClockName[metricsClock]);
+		root->Set("metrics", metricsObject);
+	}
+
+	if (!coverageFile.empty()) {
+		JsonObject* coverageObject = new JsonObject;
+		coverageObject->Set("file", coverageFile);
+		coverageObject->Set("merge", coverageMerge);
+		root->Set("coverage", coverageObject);
+	}
+
+	if (heatmapEnabled) {
+		JsonObject* heatmapObject = new JsonObject;
+		heatmapObject->Set("enabled", heatmapEnabled);
+		heatmapObject->Set("file", heatmapFile);
+		heatmapObject->Set("split", heatmapSplitName[heatmapSplit]);
+		root->Set("heatmap", heatmapObject);
+	}
+
+	if (cacheModelEnabled) {
+		JsonObject* cachesObject = new JsonObject;
+		cachesObject->Set("enabled", cacheModelEnabled);
+		for (unsigned int i = 0; i < N_CACHE_LEVELS; i++) {
+			JsonObject* cacheObject = new JsonObject;
+			cacheObject->Set("size", (int) cacheSize[i]);
+			cacheObject->Set("ways", (int) cacheWays[i]);
+			cacheObject->Set("line", (int) cacheLine[i]);
+			cachesObject->Set(cacheLevelKey[i], cacheObject);
+		}
+		cachesObject->Set("l2-latency", (int) l2Latency);
+		cachesObject->Set("memory-latency", (int) memoryLatency);
+		cachesObject->Set("stall", cacheStall);
+		root->Set("caches", cachesObject);
+	}
+
 	JsonObject* devicesObject = new JsonObject;
 	for (unsigned int il = 0; il < N_EXT_IL; il++) {
 		for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++) {
@@ -182,6 +389,16 @@ void MachineConfig::Save()
 				object->Set("file", devFiles[il][devNo]);
 				if (il == EXT_IL_INDEX(IL_ETHERNET) && getMACId(devNo))
 					object->Set("address", MACIdToString(getMACId(devNo)));
+				if (il == EXT_IL_INDEX(IL_ETHERNET)) {
+					object->Set("link-latency", (int) getLinkLatency(devNo));
+					object->Set("link-bandwidth", (int) getLinkBandwidth(devNo));
+				}
+				if (il == EXT_IL_INDEX(IL_DISK))
+					object->Set("cache-tracks", (int) getDiskCacheTracks(devNo));
+				if (il == EXT_IL_INDEX(IL_PRINTER) || il == EXT_IL_INDEX(IL_TERMINAL))
+					object->Set("output-buffering", outputBufferingName[getOutputBuffering(il, devNo)]);
+				if (il == EXT_IL_INDEX(IL_TERMINAL) && !getTerminalInput(devNo).empty())
+					object->Set("input", getTerminalInput(devNo));
 				std::string key = boost::str(boost::format("%s%u") %deviceKeyPrefix[il] %devNo);
 				devicesObject->Set(key, object);
 			}
@@ -324,6 +541,137 @@ void MachineConfig::setMACId(unsigned int devNo, const uint8_t* value)
 	}
 }
 
+unsigned int MachineConfig::getDiskCacheTracks(unsigned int devNo) const
+{
+	assert(devNo < N_DEV_PER_IL);
+	return diskCacheTracks[devNo];
+}
+
+void MachineConfig::setDiskCacheTracks(unsigned int devNo, unsigned int value)
+{
+	assert(devNo < N_DEV_PER_IL);
+	diskCacheTracks[devNo] = bumpProperty(MIN_DISK_CACHE_TRACKS, value, MAX_DISK_CACHE_TRACKS);
+}
+
+OutputBuffering MachineConfig::getOutputBuffering(unsigned int il, unsigned int devNo) const
+{
+	assert(il < N_EXT_IL && devNo < N_DEV_PER_IL);
+	return outBuffering[il][devNo];
+}
+
+void MachineConfig::setOutputBuffering(unsigned int il, unsigned int devNo, OutputBuffering setting)
+{
+	assert(il < N_EXT_IL && devNo < N_DEV_PER_IL);
+	outBuffering[il][devNo] = setting;
+}
+
+const std::string& MachineConfig::getTerminalInput(unsigned int devNo) const
+{
+	assert(devNo < N_DEV_PER_IL);
+	return termInput[devNo];
+}
+
+void MachineConfig::setTerminalInput(unsigned int devNo, const std::string& fileName)
+{
+	assert(devNo < N_DEV_PER_IL);
+	termInput[devNo] = fileName;
+}
+
+unsigned int MachineConfig::getLinkLatency(unsigned int devNo) const
+{
+	assert(devNo < N_DEV_PER_IL);
+	return linkLatency[devNo];
+}
+
+void MachineConfig::setLinkLatency(unsigned int devNo, unsigned int value)
+{
+	assert(devNo < N_DEV_PER_IL);
+	linkLatency[devNo] = bumpProperty(MIN_LINK_LATENCY, value, MAX_LINK_LATENCY);
+}
+
+unsigned int MachineConfig::getLinkBandwidth(unsigned int devNo) const
+{
+	assert(devNo < N_DEV_PER_IL);
+	return linkBandwidth[devNo];
+}
+
+void MachineConfig::setLinkBandwidth(unsigned int devNo, unsigned int value)
+{
+	assert(devNo < N_DEV_PER_IL);
+	linkBandwidth[devNo] = bumpProperty(MIN_LINK_BANDWIDTH, value, MAX_LINK_BANDWIDTH);
+}
+
+void MachineConfig::setTraceASID(Word asid)
+{
+	traceASID = bumpProperty(MIN_ASID, asid, MAX_ASID);
+}
+
+void MachineConfig::setTraceRange(Word start, Word end)
+{
+	traceStart = start;
+	traceEnd = std::max(start, end);
+}
+
+void MachineConfig::setSamplingInterval(unsigned int cycles)
+{
+	samplingInterval = bumpProperty(MIN_SAMPLING_INTERVAL, cycles, MAX_SAMPLING_INTERVAL);
+}
+
+void MachineConfig::setMetricsInterval(unsigned int interval)
+{
+	metricsInterval = bumpProperty(MIN_METRICS_INTERVAL, interval, MAX_METRICS_INTERVAL);
+}
+
+unsigned int MachineConfig::getCacheSize(CacheLevel level) const
+{
+	assert(level < N_CACHE_LEVELS);
+	return cacheSize[level];
+}
+
+void MachineConfig::setCacheSize(CacheLevel level, unsigned int kb)
+{
+	assert(level < N_CACHE_LEVELS);
+	cacheSize[level] = bumpProperty(MIN_CACHE_SIZE, kb, MAX_CACHE_SIZE);
+}
+
+unsigned int MachineConfig::getCacheWays(CacheLevel level) const
+{
+	assert(level < N_CACHE_LEVELS);
+	return cacheWays[level];
+}
+
+void MachineConfig::setCacheWays(CacheLevel level, unsigned int ways)
+{
+	assert(level < N_CACHE_LEVELS);
+	cacheWays[level] = bumpProperty(MIN_CACHE_WAYS, ways, MAX_CACHE_WAYS);
+}
+
+unsigned int MachineConfig::getCacheLineSize(CacheLevel level) const
+{
+	assert(level < N_CACHE_LEVELS);
+	return cacheLine[level];
+}
+
+// Line sizes are rounded down to a power of two
+void MachineConfig::setCacheLineSize(CacheLevel level, unsigned int bytes)
+{
+	assert(level < N_CACHE_LEVELS);
+	bytes = bumpProperty(MIN_CACHE_LINE, bytes, MAX_CACHE_LINE);
+	cacheLine[level] = MIN_CACHE_LINE;
+	while (cacheLine[level] * 2 <= bytes)
+		cacheLine[level] *= 2;
+}
+
+void MachineConfig::setL2Latency(unsigned int cycles)
+{
+	l2Latency = bumpProperty(MIN_CACHE_LATENCY, cycles, MAX_CACHE_LATENCY);
+}
+
+void MachineConfig::setMemoryLatency(unsigned int cycles)
+{
+	memoryLatency = bumpProperty(MIN_CACHE_LATENCY, cycles, MAX_CACHE_LATENCY);
+}
+
 void MachineConfig::resetToFactorySettings()
 {
 	setNumProcessors(DEFAULT_NUM_CPUS);
@@ -342,9 +690,50 @@ void MachineConfig::resetToFactorySettings()
 	setROM(ROM_TYPE_STAB, "kernel.stab.umps");
 	setSymbolTableASID(MAX_ASID);
 
+	setTraceFile("");
+	setTraceASID(MAX_ASID);
+	setTraceRange(MINWORDVAL, MAXWORDVAL);
+	setTraceMode(TRACE_MODE_ALL);
+
+	setSamplingFile("");
+	setSamplingInterval(DEFAULT_SAMPLING_INTERVAL);
+	setCallGraphFile("");
+
+	setTimelineFile("");
+
+	setMetricsFile("");
+	setMetricsFormat(METRICS_FORMAT_JSON);
+	setMetricsInterval(DEFAULT_METRICS_INTERVAL);
+	setMetricsClock(METRICS_CLOCK_HOST);
+
+	setCoverageFile("");
+	setCoverageMergeEnabled(false);
+
+	setHeatmapEnabled(false);
+	setHeatmapFile("");
+	setHeatmapSplit(HEATMAP_SPLIT_NONE);
+
+	setCacheModelEnabled(false);
+	for (unsigned int i = 0; i < N_CACHE_LEVELS; i++) {
+		setCacheSize((CacheLevel) i, i == CACHE_L2 ? DEFAULT_L2_CACHE_SIZE : DEFAULT_L1_CACHE_SIZE);
+		setCacheWays((CacheLevel) i, DEFAULT_CACHE_WAYS);
+		setCacheLineSize((CacheLevel) i, DEFAULT_CACHE_LINE);
+	}
+	setL2Latency(DEFAULT_L2_LATENCY);
+	setMemoryLatency(DEFAULT_MEMORY_LATENCY);
+	setCacheStallEnabled(false);
+
 	for (unsigned int i = 0; i < N_EXT_IL; ++i)
-		for (unsigned int j = 0; j < N_DEV_PER_IL; ++j)
+		for (unsigned int j = 0; j < N_DEV_PER_IL; ++j) {
 			devEnabled[i][j] = false;
+			outBuffering[i][j] = DEFAULT_OUTPUT_BUFFERING;
+		}
+
+	for (unsigned int j = 0; j < N_DEV_PER_IL; ++j) {
+		setDiskCacheTracks(j, DEFAULT_DISK_CACHE_TRACKS);
+		setLinkLatency(j, DEFAULT_LINK_LATENCY);
+		setLinkBandwidth(j, DEFAULT_LINK_BANDWIDTH);
+	}
 }
 
 bool MachineConfig::validFileMagic(Word tag, const char* fName)
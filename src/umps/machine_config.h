@@ -40,6 +40,58 @@ enum ROMType {
 	N_ROM_TYPES
 };
 
+// Output buffering policies for character devices (printers and
+// terminals): flush every character, flush on newline, or flush only
+// when the buffer fills up. Buffered output is also flushed at most
+// 100 ms of simulated time after it was written, and whenever the
+// machine stops, halts or a processor goes idle.
+enum OutputBuffering {
+	OUTPUT_UNBUFFERED,
+	OUTPUT_LINE_BUFFERED,
+	OUTPUT_FULLY_BUFFERED,
+	N_OUTPUT_BUFFERING
+};
+
+// Instruction trace filter on processor mode (see TraceRecorder)
+enum TraceMode {
+	TRACE_MODE_ALL,
+	TRACE_MODE_KERNEL,
+	TRACE_MODE_USER,
+	N_TRACE_MODES
+};
+
+// Metrics stream line format, and the clock its interval is measured
+// on (see MetricsStream)
+enum MetricsFormat {
+	METRICS_FORMAT_JSON,
+	METRICS_FORMAT_CSV,
+	N_METRICS_FORMATS
+};
+
+enum MetricsClock {
+	METRICS_CLOCK_HOST,
+	METRICS_CLOCK_GUEST,
+	N_METRICS_CLOCKS
+};
+
+// Memory heatmap counters: all together, or one set per cpu or per
+// ASID (see MemoryHeatmap)
+enum HeatmapSplit {
+	HEATMAP_SPLIT_NONE,
+	HEATMAP_SPLIT_CPU,
+	HEATMAP_SPLIT_ASID,
+	N_HEATMAP_SPLITS
+};
+
+// Levels of the simulated cache hierarchy (see CacheModel): private
+// L1 instruction and data caches, and a shared L2
+enum CacheLevel {
+	CACHE_L1I,
+	CACHE_L1D,
+	CACHE_L2,
+	N_CACHE_LEVELS
+};
+
 class MachineConfig {
 public:
 	static const Word MIN_RAM = 8;
@@ -47,7 +99,7 @@ public:
 	static const Word DEFAUlT_RAM_SIZE = 64;
 
 	static const unsigned int MIN_CPUS = 1;
-	static const unsigned int MAX_CPUS = 16;
+	static const unsigned int MAX_CPUS = 64;
 	static const unsigned int DEFAULT_NUM_CPUS = 1;
 
 	static const unsigned int MIN_CLOCK_RATE = 1;
@@ -64,6 +116,47 @@ public:
 	static const Word MIN_ASID = 0;
 	static const Word MAX_ASID = 64;
 
+	static const unsigned int MIN_DISK_CACHE_TRACKS = 0;
+	static const unsigned int MAX_DISK_CACHE_TRACKS = 16;
+	static const unsigned int DEFAULT_DISK_CACHE_TRACKS = 0;
+
+	// Ethernet link parameters (used on virtual switches only):
+	// latency is in microseconds and bandwidth in kbit/s, where a
+	// bandwidth of 0 means an unlimited one
+	static const unsigned int MIN_LINK_LATENCY = 0;
+	static const unsigned int MAX_LINK_LATENCY = 1000000;
+	static const unsigned int DEFAULT_LINK_LATENCY = 0;
+	static const unsigned int MIN_LINK_BANDWIDTH = 0;
+	static const unsigned int MAX_LINK_BANDWIDTH = 10000000;
+	static const unsigned int DEFAULT_LINK_BANDWIDTH = 0;
+
+	static const unsigned int MIN_SAMPLING_INTERVAL = 100;
+	static const unsigned int MAX_SAMPLING_INTERVAL = 100000000;
+	static const unsigned int DEFAULT_SAMPLING_INTERVAL = 10000;
+
+	static const unsigned int MIN_METRICS_INTERVAL = 1;
+	static const unsigned int MAX_METRICS_INTERVAL = 1000000000;
+	static const unsigned int DEFAULT_METRICS_INTERVAL = 1000;
+
+	// Cache geometry: size in KB (0 for no cache at that level),
+	// associativity and line size in bytes; latencies in cycles
+	static const unsigned int MIN_CACHE_SIZE = 0;
+	static const unsigned int MAX_CACHE_SIZE = 4096;
+	static const unsigned int DEFAULT_L1_CACHE_SIZE = 8;
+	static const unsigned int DEFAULT_L2_CACHE_SIZE = 0;
+	static const unsigned int MIN_CACHE_WAYS = 1;
+	static const unsigned int MAX_CACHE_WAYS = 16;
+	static const unsigned int DEFAULT_CACHE_WAYS = 2;
+	static const unsigned int MIN_CACHE_LINE = 16;
+	static const unsigned int MAX_CACHE_LINE = 256;
+	static const unsigned int DEFAULT_CACHE_LINE = 32;
+	static const unsigned int MIN_CACHE_LATENCY = 0;
+	static const unsigned int MAX_CACHE_LATENCY = 1000;
+	static const unsigned int DEFAULT_L2_LATENCY = 10;
+	static const unsigned int DEFAULT_MEMORY_LATENCY = 50;
+
+	static const OutputBuffering DEFAULT_OUTPUT_BUFFERING = OUTPUT_LINE_BUFFERED;
+
 	static MachineConfig* LoadFromFile(const std::string& fileName, std::string& error);
 	static MachineConfig* Create(const std::string& fileName);
 
@@ -122,6 +215,165 @@ public:
 	const std::string& getDeviceFile(unsigned int il, unsigned int devNo) const;
 	const uint8_t* getMACId(unsigned int devNo) const;
 	void setMACId(unsigned int devNo, const uint8_t* value);
+	unsigned int getDiskCacheTracks(unsigned int devNo) const;
+	void setDiskCacheTracks(unsigned int devNo, unsigned int value);
+	OutputBuffering getOutputBuffering(unsigned int il, unsigned int devNo) const;
+	void setOutputBuffering(unsigned int il, unsigned int devNo, OutputBuffering setting);
+	const std::string& getTerminalInput(unsigned int devNo) const;
+	void setTerminalInput(unsigned int devNo, const std::string& fileName);
+	unsigned int getLinkLatency(unsigned int devNo) const;
+	void setLinkLatency(unsigned int devNo, unsigned int value);
+	unsigned int getLinkBandwidth(unsigned int devNo) const;
+	void setLinkBandwidth(unsigned int devNo, unsigned int value);
+
+	// Instruction tracing: no trace is recorded if the trace file
+	// is not set; an ASID of MAX_ASID matches any ASID
+	void setTraceFile(const std::string& fileName) {
+		traceFile = fileName;
+	}
+	const std::string& getTraceFile() const {
+		return traceFile;
+	}
+	void setTraceASID(Word asid);
+	Word getTraceASID() const {
+		return traceASID;
+	}
+	void setTraceRange(Word start, Word end);
+	Word getTraceStart() const {
+		return traceStart;
+	}
+	Word getTraceEnd() const {
+		return traceEnd;
+	}
+	void setTraceMode(TraceMode mode) {
+		traceMode = mode;
+	}
+	TraceMode getTraceMode() const {
+		return traceMode;
+	}
+
+	// Sampling profiler: the profile is written to the sampling
+	// file, if set, every interval cycles
+	void setSamplingFile(const std::string& fileName) {
+		samplingFile = fileName;
+	}
+	const std::string& getSamplingFile() const {
+		return samplingFile;
+	}
+	void setSamplingInterval(unsigned int cycles);
+	unsigned int getSamplingInterval() const {
+		return samplingInterval;
+	}
+
+	// Call graph profiler: the callgrind profile is written to the
+	// call graph file, if set
+	void setCallGraphFile(const std::string& fileName) {
+		callGraphFile = fileName;
+	}
+	const std::string& getCallGraphFile() const {
+		return callGraphFile;
+	}
+
+	// Timeline: cpu and device activity is written to the timeline
+	// file, if set, as Chrome trace-event JSON
+	void setTimelineFile(const std::string& fileName) {
+		timelineFile = fileName;
+	}
+	const std::string& getTimelineFile() const {
+		return timelineFile;
+	}
+
+	// Metrics stream: a line of machine metrics is written to the
+	// metrics file (or Unix socket), if set, every interval
+	// milliseconds of host time or cycles of guest time
+	void setMetricsFile(const std::string& fileName) {
+		metricsFile = fileName;
+	}
+	const std::string& getMetricsFile() const {
+		return metricsFile;
+	}
+	void setMetricsFormat(MetricsFormat format) {
+		metricsFormat = format;
+	}
+	MetricsFormat getMetricsFormat() const {
+		return metricsFormat;
+	}
+	void setMetricsInterval(unsigned int interval);
+	unsigned int getMetricsInterval() const {
+		return metricsInterval;
+	}
+	void setMetricsClock(MetricsClock clock) {
+		metricsClock = clock;
+	}
+	MetricsClock getMetricsClock() const {
+		return metricsClock;
+	}
+
+	// Code coverage: the report is written to the coverage file, if
+	// set, either replacing it or adding up to the counts it holds
+	void setCoverageFile(const std::string& fileName) {
+		coverageFile = fileName;
+	}
+	const std::string& getCoverageFile() const {
+		return coverageFile;
+	}
+	void setCoverageMergeEnabled(bool setting) {
+		coverageMerge = setting;
+	}
+	bool isCoverageMergeEnabled() const {
+		return coverageMerge;
+	}
+
+	// Memory heatmap: per-frame access counters, exported on exit
+	// to the heatmap file (if set) as JSON if its name ends with
+	// ".json", as CSV otherwise
+	void setHeatmapEnabled(bool setting) {
+		heatmapEnabled = setting;
+	}
+	bool isHeatmapEnabled() const {
+		return heatmapEnabled;
+	}
+	void setHeatmapFile(const std::string& fileName) {
+		heatmapFile = fileName;
+	}
+	const std::string& getHeatmapFile() const {
+		return heatmapFile;
+	}
+	void setHeatmapSplit(HeatmapSplit split) {
+		heatmapSplit = split;
+	}
+	HeatmapSplit getHeatmapSplit() const {
+		return heatmapSplit;
+	}
+
+	// Cache simulation: when stalls are enabled, misses delay the
+	// processor by the latency of the level serving them
+	void setCacheModelEnabled(bool setting) {
+		cacheModelEnabled = setting;
+	}
+	bool isCacheModelEnabled() const {
+		return cacheModelEnabled;
+	}
+	unsigned int getCacheSize(CacheLevel level) const;
+	void setCacheSize(CacheLevel level, unsigned int kb);
+	unsigned int getCacheWays(CacheLevel level) const;
+	void setCacheWays(CacheLevel level, unsigned int ways);
+	unsigned int getCacheLineSize(CacheLevel level) const;
+	void setCacheLineSize(CacheLevel level, unsigned int bytes);
+	void setL2Latency(unsigned int cycles);
+	unsigned int getL2Latency() const {
+		return l2Latency;
+	}
+	void setMemoryLatency(unsigned int cycles);
+	unsigned int getMemoryLatency() const {
+		return memoryLatency;
+	}
+	void setCacheStallEnabled(bool setting) {
+		cacheStall = setting;
+	}
+	bool isCacheStallEnabled() const {
+		return cacheStall;
+	}
 
 private:
 	MachineConfig(const std::string& fileName);
@@ -145,8 +397,51 @@ private:
 	std::string devFiles[N_EXT_IL][N_DEV_PER_IL];
 	bool devEnabled[N_EXT_IL][N_DEV_PER_IL];
 	scoped_array<uint8_t> macId[N_DEV_PER_IL];
+	unsigned int diskCacheTracks[N_DEV_PER_IL];
+	OutputBuffering outBuffering[N_EXT_IL][N_DEV_PER_IL];
+	std::string termInput[N_DEV_PER_IL];
+	unsigned int linkLatency[N_DEV_PER_IL];
+	unsigned int linkBandwidth[N_DEV_PER_IL];
+
+	std::string traceFile;
+	Word traceASID;
+	Word traceStart;
+	Word traceEnd;
+	TraceMode traceMode;
+
+	std::string samplingFile;
+	unsigned int samplingInterval;
+	std::string callGraphFile;
+
+	std::string timelineFile;
+
+	std::string metricsFile;
+	MetricsFormat metricsFormat;
+	unsigned int metricsInterval;
+	MetricsClock metricsClock;
+
+	std::string coverageFile;
+	bool coverageMerge;
+
+	bool heatmapEnabled;
+	std::string heatmapFile;
+	HeatmapSplit heatmapSplit;
+
+	bool cacheModelEnabled;
+	unsigned int cacheSize[N_CACHE_LEVELS];
+	unsigned int cacheWays[N_CACHE_LEVELS];
+	unsigned int cacheLine[N_CACHE_LEVELS];
+	unsigned int l2Latency;
+	unsigned int memoryLatency;
+	bool cacheStall;
 
 	static const char* const deviceKeyPrefix[N_EXT_IL];
+	static const char* const outputBufferingName[N_OUTPUT_BUFFERING];
+	static const char* const traceModeName[N_TRACE_MODES];
+	static const char* const metricsFormatName[N_METRICS_FORMATS];
+	static const char* const metricsClockName[N_METRICS_CLOCKS];
+	static const char* const heatmapSplitName[N_HEATMAP_SPLITS];
+	static const char* const cacheLevelKey[N_CACHE_LEVELS];
 };
 
 #endif // UMPS_MACHINE_CONFIG_H
@@ -0,0 +1,212 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/memory_heatmap.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "umps/arch.h"
+#include "umps/const.h"
+#include "umps/error.h"
+#include "umps/processor.h"
+
+const char* const MemoryHeatmap::splitName[N_HEATMAP_SPLITS] = {
+	"none",
+	"cpu",
+	"asid"
+};
+
+const char* const MemoryHeatmap::accessName[N_HEATMAP_ACCESS_TYPES] = {
+	"reads",
+	"writes",
+	"fetches"
+};
+
+HIDDEN unsigned int counterRows(const MachineConfig* config)
+{
+	switch (config->getHeatmapSplit()) {
+	case HEATMAP_SPLIT_CPU:
+		return config->getNumProcessors();
+	case HEATMAP_SPLIT_ASID:
+		return MAXASID;
+	default:
+		return 1;
+	}
+}
+
+MemoryHeatmap::MemoryHeatmap(const MachineConfig* config)
+	: split(config->getHeatmapSplit()),
+	  frames(config->getRamSize()),
+	  rows(counterRows(config)),
+	  counters(new uint64_t[rows * frames * N_HEATMAP_ACCESS_TYPES]),
+	  dmaCounters(new uint64_t[frames]),
+	  fileName(config->getHeatmapFile())
+{
+	// Find out now if the counters cannot be written
+	if (!fileName.empty()) {
+		FILE* file = fopen(fileName.c_str(), "a");
+		if (file == NULL)
+			throw FileError(fileName);
+		fclose(file);
+	}
+
+	Reset();
+}
+
+MemoryHeatmap::~MemoryHeatmap()
+{
+	if (fileName.empty())
+		return;
+
+	FILE* file = fopen(fileName.c_str(), "w");
+	if (file == NULL)
+		return;
+
+	size_t len = fileName.length();
+	if (len >= 5 && fileName.compare(len - 5, 5, ".json") == 0)
+		writeJSON(file);
+	else
+		writeCSV(file);
+	fclose(file);
+}
+
+void MemoryHeatmap::Access(Word addr, HeatmapAccess type, const Processor* cpu)
+{
+	Word frame = (addr - RAMBASE) / (FRAMESIZE * WS);
+	if (frame >= frames)
+		return;
+
+	unsigned int row = 0;
+	if (split == HEATMAP_SPLIT_CPU)
+		row = cpu->Id();
+	else if (split == HEATMAP_SPLIT_ASID)
+		row = cpu->getASID();
+	counters[(row * frames + frame) * N_HEATMAP_ACCESS_TYPES + type]++;
+}
+
+void MemoryHeatmap::DMA(Word startAddr, Word words)
+{
+	if (startAddr < RAMBASE)
+		return;
+
+	Word addr = startAddr;
+	Word end = startAddr + words * WS;
+
+	while (addr < end) {
+		Word frame = (addr - RAMBASE) / (FRAMESIZE * WS);
+		if (frame >= frames)
+			break;
+		Word frameEnd = std::min(end, (Word) (RAMBASE + (frame + 1) * FRAMESIZE * WS));
+		dmaCounters[frame] += (frameEnd - addr) / WS;
+		addr = frameEnd;
+	}
+}
+
+uint64_t MemoryHeatmap::getTotal(unsigned int frame, HeatmapAccess type) const
+{
+	uint64_t total = 0;
+	for (unsigned int row = 0; row < rows; row++)
+		total += getCount(row, frame, type);
+	return total;
+}
+
+void MemoryHeatmap::Reset()
+{
+	memset(counters.get(), 0, rows * frames * N_HEATMAP_ACCESS_TYPES * sizeof(uint64_t));
+	memset(dmaCounters.get(), 0, frames * sizeof(uint64_t));
+}
+
+// One line for each frame accessed, or for each frame and cpu/ASID
+// when split; DMA counts go on a line of their own with an empty
+// cpu/ASID field
+void MemoryHeatmap::writeCSV(FILE* file) const
+{
+	fprintf(file, "frame,address,%s%sreads,writes,fetches,dma\n",
+	        split != HEATMAP_SPLIT_NONE ? splitName[split] : "",
+	        split != HEATMAP_SPLIT_NONE ? "," : "");
+
+	for (unsigned int frame = 0; frame < frames; frame++) {
+		Word addr = RAMBASE + frame * FRAMESIZE * WS;
+
+		for (unsigned int row = 0; row < rows; row++) {
+			uint64_t r = getCount(row, frame, HEATMAP_READ);
+			uint64_t w = getCount(row, frame, HEATMAP_WRITE);
+			uint64_t f = getCount(row, frame, HEATMAP_FETCH);
+			uint64_t d = (split == HEATMAP_SPLIT_NONE) ? dmaCounters[frame] : 0;
+			if (r + w + f + d == 0)
+				continue;
+			fprintf(file, "%u,0x%.8X,", frame, addr);
+			if (split != HEATMAP_SPLIT_NONE)
+				fprintf(file, "%u,", row);
+			fprintf(file, "%llu,%llu,%llu,%llu\n", (unsigned long long) r,
+			        (unsigned long long) w, (unsigned long long) f, (unsigned long long) d);
+		}
+
+		if (split != HEATMAP_SPLIT_NONE && dmaCounters[frame] > 0)
+			fprintf(file, "%u,0x%.8X,,0,0,0,%llu\n", frame, addr,
+			        (unsigned long long) dmaCounters[frame]);
+	}
+}
+
+void MemoryHeatmap::writeJSON(FILE* file) const
+{
+	fprintf(file, "{\n    \"frame-size\": %u,\n    \"split\": \"%s\",\n    \"frames\": [",
+	        FRAMESIZE * WS, splitName[split]);
+
+	const char* sep = "\n";
+	for (unsigned int frame = 0; frame < frames; frame++) {
+		uint64_t total[N_HEATMAP_ACCESS_TYPES];
+		uint64_t sum = dmaCounters[frame];
+		for (unsigned int t = 0; t < N_HEATMAP_ACCESS_TYPES; t++)
+			sum += total[t] = getTotal(frame, (HeatmapAccess) t);
+		if (sum == 0)
+			continue;
+
+		fprintf(file, "%s        {\"frame\": %u, \"address\": \"0x%.8X\"", sep, frame,
+		        (Word) (RAMBASE + frame * FRAMESIZE * WS));
+		for (unsigned int t = 0; t < N_HEATMAP_ACCESS_TYPES; t++)
+			fprintf(file, ", \"%s\": %llu", accessName[t], (unsigned long long) total[t]);
+		fprintf(file, ", \"dma\": %llu", (unsigned long long) dmaCounters[frame]);
+
+		if (split != HEATMAP_SPLIT_NONE) {
+			fprintf(file, ",\n         \"by-%s\": [", splitName[split]);
+			const char* rowSep = "";
+			for (unsigned int row = 0; row < rows; row++) {
+				uint64_t r = getCount(row, frame, HEATMAP_READ);
+				uint64_t w = getCount(row, frame, HEATMAP_WRITE);
+				uint64_t f = getCount(row, frame, HEATMAP_FETCH);
+				if (r + w + f == 0)
+					continue;
+				fprintf(file, "%s{\"%s\": %u, \"reads\": %llu, \"writes\": %llu, \"fetches\": %llu}",
+				        rowSep, splitName[split], row, (unsigned long long) r,
+				        (unsigned long long) w, (unsigned long long) f);
+				rowSep = ", ";
+			}
+			fprintf(file, "]");
+		}
+		fprintf(file, "}");
+		sep = ",\n";
+	}
+
+	fprintf(file, "\n    ]\n}\n");
+}
@@ -0,0 +1,97 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_MEMORY_HEATMAP_H
+#define UMPS_MEMORY_HEATMAP_H
+
+#include <stdio.h>
+
+#include <string>
+
+#include "base/lang.h"
+#include "umps/machine_config.h"
+
+class Processor;
+
+enum HeatmapAccess {
+	HEATMAP_READ,
+	HEATMAP_WRITE,
+	HEATMAP_FETCH,
+	N_HEATMAP_ACCESS_TYPES
+};
+
+/*
+ * MemoryHeatmap counts the accesses to each RAM frame: reads, writes
+ * and instruction fetches by processors, split by cpu or ASID as
+ * configured in MachineConfig, and words moved by device DMA (which
+ * belong to no cpu). Counters are written to the heatmap file, if
+ * set, when the heatmap is destroyed.
+ */
+class MemoryHeatmap {
+public:
+	MemoryHeatmap(const MachineConfig* config);
+	~MemoryHeatmap();
+
+	void Access(Word addr, HeatmapAccess type, const Processor* cpu);
+	void DMA(Word startAddr, Word words);
+
+	HeatmapSplit getSplit() const {
+		return split;
+	}
+	// Counter sets: 1, or one per cpu or ASID
+	unsigned int getRows() const {
+		return rows;
+	}
+	unsigned int getFrames() const {
+		return frames;
+	}
+
+	uint64_t getCount(unsigned int row, unsigned int frame, HeatmapAccess type) const {
+		return counters[(row * frames + frame) * N_HEATMAP_ACCESS_TYPES + type];
+	}
+	// Accesses of a type by all cpus
+	uint64_t getTotal(unsigned int frame, HeatmapAccess type) const;
+	uint64_t getDMACount(unsigned int frame) const {
+		return dmaCounters[frame];
+	}
+
+	void Reset();
+
+private:
+	void writeCSV(FILE* file) const;
+	void writeJSON(FILE* file) const;
+
+	const HeatmapSplit split;
+	const unsigned int frames;
+	const unsigned int rows;
+
+	scoped_array<uint64_t> counters;
+	scoped_array<uint64_t> dmaCounters;
+
+	std::string fileName;
+
+	static const char* const splitName[N_HEATMAP_SPLITS];
+	static const char* const accessName[N_HEATMAP_ACCESS_TYPES];
+
+	DISABLE_COPY_AND_ASSIGNMENT(MemoryHeatmap);
+};
+
+#endif // UMPS_MEMORY_HEATMAP_H
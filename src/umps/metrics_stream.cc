@@ -0,0 +1,226 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/metrics_stream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "umps/const.h"
+#include "umps/error.h"
+#include "umps/machine.h"
+#include "umps/processor.h"
+#include "umps/systembus.h"
+#include "umps/device.h"
+
+// Device class names, by interrupt line
+HIDDEN const char* const devClassName[N_EXT_IL] = {
+	"disk", "flash", "network", "printer", "terminal"
+};
+
+// This function returns how much a processor counter grew since the
+// previous sample: a processor reset zeroes its counters, in which case
+// the new value is all the growth there is
+HIDDEN uint64_t counterDelta(uint64_t value, uint64_t last)
+{
+	return value >= last ? value - last : value;
+}
+
+// This function connects to the Unix stream socket at path, returning
+// the socket descriptor, or -1 on errors
+HIDDEN int connectSocket(const std::string& path)
+{
+	struct sockaddr_un addr;
+	if (path.size() >= sizeof(addr.sun_path))
+		return -1;
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path.c_str());
+	if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0 ||
+	    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+MetricsStream::MetricsStream(const MachineConfig* config, Machine* machine)
+	: config(config),
+	  machine(machine),
+	  format(config->getMetricsFormat()),
+	  clock(config->getMetricsClock()),
+	  interval(config->getMetricsInterval()),
+	  fileName(config->getMetricsFile()),
+	  start(Clock::now()),
+	  nextTime(start + std::chrono::milliseconds(interval)),
+	  nextCycle(interval),
+	  lastTime(start),
+	  lastInstructions(config->getNumProcessors(), 0),
+	  lastCycles(config->getNumProcessors(), 0),
+	  lastIdle(config->getNumProcessors(), 0),
+	  lastToD(0)
+{
+	// An existing socket is connected to; anything else is a file
+	struct stat st;
+	isSocket = stat(fileName.c_str(), &st) == 0 && S_ISSOCK(st.st_mode);
+	if (isSocket)
+		fd = connectSocket(fileName);
+	else
+		fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		throw FileError(fileName);
+
+	if (format == METRICS_FORMAT_CSV) {
+		std::string header = "time,cycles,mips";
+		for (unsigned int i = 0; i < config->getNumProcessors(); i++)
+			header += ",cpu" + std::to_string(i);
+		header += ",events";
+		for (unsigned int il = 0; il < N_EXT_IL; il++)
+			header += std::string(",") + devClassName[il];
+		header += ",stoppoint-hits\n";
+		writeLine(header);
+	}
+}
+
+MetricsStream::~MetricsStream()
+{
+	if (fd >= 0) {
+		sample();
+		close(fd);
+	}
+}
+
+void MetricsStream::Poll()
+{
+	if (fd < 0)
+		return;
+
+	if (clock == METRICS_CLOCK_GUEST) {
+		uint64_t tod = machine->getBus()->getToD();
+		if (tod < nextCycle)
+			return;
+		// Catch up at once after a long step, rather than bursting
+		nextCycle = tod - (tod % interval) + interval;
+	} else {
+		Clock::time_point now = Clock::now();
+		if (now < nextTime)
+			return;
+		nextTime = now + std::chrono::milliseconds(interval);
+	}
+
+	sample();
+}
+
+void MetricsStream::sample()
+{
+	Clock::time_point now = Clock::now();
+	uint64_t tod = machine->getBus()->getToD();
+	double elapsed = std::chrono::duration<double>(now - lastTime).count();
+	uint64_t cycles = tod - lastToD;
+	bool json = (format == METRICS_FORMAT_JSON);
+	char buf[64];
+
+	uint64_t instructions = 0;
+	for (unsigned int i = 0; i < config->getNumProcessors(); i++) {
+		uint64_t value = machine->getProcessor(i)->getPerfCounter(PERF_INSTRUCTIONS);
+		instructions += counterDelta(value, lastInstructions[i]);
+		lastInstructions[i] = value;
+	}
+
+	std::string line;
+	snprintf(buf, sizeof(buf), json ? "{\"time\": %.3f, \"cycles\": %llu, \"mips\": %.3f"
+	                                : "%.3f,%llu,%.3f",
+	         std::chrono::duration<double>(now - start).count(), (unsigned long long) tod,
+	         elapsed > 0 ? instructions / elapsed / 1e6 : 0.0);
+	line += buf;
+
+	line += json ? ", \"cpus\": [" : "";
+	for (unsigned int i = 0; i < config->getNumProcessors(); i++) {
+		Processor* cpu = machine->getProcessor(i);
+		uint64_t total = counterDelta(cpu->getPerfCounter(PERF_CYCLES), lastCycles[i]);
+		uint64_t idle = counterDelta(cpu->getPerfCounter(PERF_IDLE_CYCLES), lastIdle[i]);
+		uint64_t running = total > idle ? total - idle : 0;
+		snprintf(buf, sizeof(buf), json && i == 0 ? "%.3f" : ",%.3f",
+		         cycles > 0 ? (double) running / cycles : 0.0);
+		line += buf;
+		lastCycles[i] = cpu->getPerfCounter(PERF_CYCLES);
+		lastIdle[i] = cpu->getPerfCounter(PERF_IDLE_CYCLES);
+	}
+
+	snprintf(buf, sizeof(buf), json ? "], \"events\": %llu, \"queues\": {" : ",%llu",
+	         (unsigned long long) machine->getBus()->getEventCount());
+	line += buf;
+
+	for (unsigned int il = 0; il < N_EXT_IL; il++) {
+		unsigned int depth = 0;
+		for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++)
+			depth += machine->getDevice(il, devNo)->getQueueDepth();
+		if (json)
+			snprintf(buf, sizeof(buf), "%s\"%s\": %u", il ? ", " : "", devClassName[il], depth);
+		else
+			snprintf(buf, sizeof(buf), ",%u", depth);
+		line += buf;
+	}
+
+	snprintf(buf, sizeof(buf), json ? "}, \"stoppoint-hits\": %llu}\n" : ",%llu\n",
+	         (unsigned long long) machine->getStoppointHits());
+	line += buf;
+
+	lastTime = now;
+	lastToD = tod;
+
+	writeLine(line);
+}
+
+void MetricsStream::writeLine(const std::string& line)
+{
+	if (!isSocket) {
+		if (write(fd, line.data(), line.size()) < 0) {
+			close(fd);
+			fd = -1;
+		}
+		return;
+	}
+
+	// A reader which is behind loses the samples it has no room for
+	// (the rest of a line only partly sent goes first), one which
+	// went away ends the stream
+	if (pending.empty())
+		pending = line;
+	ssize_t n = send(fd, pending.data(), pending.size(), MSG_NOSIGNAL);
+	if (n >= 0) {
+		pending.erase(0, n);
+	} else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+		close(fd);
+		fd = -1;
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_METRICS_STREAM_H
+#define UMPS_METRICS_STREAM_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "base/lang.h"
+#include "umps/arch.h"
+#include "umps/machine_config.h"
+
+class Machine;
+
+/*
+ * MetricsStream periodically writes a line of machine metrics to a
+ * file or to a Unix socket, as configured in MachineConfig: a JSON
+ * object per line, or CSV with a header line. Each sample carries
+ * host time (seconds since the stream started), machine cycles, the
+ * host throughput in millions of instructions per second, the share
+ * of cycles each cpu spent running (not idle nor halted), device
+ * events processed, the number of outstanding operations of each
+ * device class, and stoppoint hits. Rates and shares refer to the
+ * period since the previous sample.
+ *
+ * The machine polls the stream at the end of each step() and skip()
+ * call, so samples come at the first such boundary after the interval
+ * elapsed; a last sample is written when the stream is destroyed.
+ *
+ * A socket is written to without blocking: samples a lagging reader
+ * has no room for are dropped, and the stream stops for good if the
+ * reader goes away (as it does on file write errors).
+ */
+class MetricsStream {
+public:
+	MetricsStream(const MachineConfig* config, Machine* machine);
+	~MetricsStream();
+
+	void Poll();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	void sample();
+	void writeLine(const std::string& line);
+
+	const MachineConfig* const config;
+	Machine* const machine;
+
+	const MetricsFormat format;
+	const MetricsClock clock;
+	const unsigned int interval;
+
+	std::string fileName;
+	int fd;
+	bool isSocket;
+	// Part of a line the socket had no room for
+	std::string pending;
+
+	const Clock::time_point start;
+	Clock::time_point nextTime;
+	uint64_t nextCycle;
+
+	// Counters at the previous sample, per processor
+	Clock::time_point lastTime;
+	std::vector<uint64_t> lastInstructions;
+	std::vector<uint64_t> lastCycles;
+	std::vector<uint64_t> lastIdle;
+	uint64_t lastToD;
+
+	DISABLE_COPY_AND_ASSIGNMENT(MetricsStream);
+};
+
+#endif // UMPS_METRICS_STREAM_H
@@ -24,9 +24,12 @@
  *
  * This is a stand-alone program which produces "empty" disk image files
  * with specified performance figures and geometry, or assembles existing
- * data files into a single flash device image file.  Disk image files are
- * used to emulate disk devices; flash device image files are used to emulate
- * flash drive devices.
+ * data files (or a whole host directory tree) into a single flash device
+ * image file.  Disk image files are used to emulate disk devices; flash
+ * device image files are used to emulate flash drive devices.
+ *
+ * Image files are created sparse: all-zero blocks are never written
+ * explicitly, but left as holes and accounted for by a final truncate.
  *
  ****************************************************************************/
 
@@ -35,6 +38,11 @@
 #include <ctype.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
+#include <ftw.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include <umps/const.h>
 #include "umps/types.h"
@@ -73,7 +81,15 @@ HIDDEN bool decodeDiskP(int idx, unsigned int * par, const char * str);
 HIDDEN bool decodeFlashP(int idx, unsigned int * par, const char * str);
 HIDDEN int writeDisk(const char * prg, const char * fname);
 HIDDEN int writeFlash(const char * prg, const char * fname, const char * file);
+HIDDEN int importDir(const char * prg, const char * fname, const char * dir);
 HIDDEN void testForCore(FILE * rfile);
+HIDDEN bool isZeroBlock(const Word * blk);
+HIDDEN bool putBlock(FILE * ofile, const Word * blk);
+HIDDEN bool finishImage(FILE * ofile, unsigned int hdrWords, unsigned int blocks);
+HIDDEN int importEntry(const char * path, const struct stat * st, int flag, struct FTW * ftw);
+HIDDEN bool putBytes(const void * data, size_t len);
+HIDDEN bool splitTarName(const char * name, size_t * plen);
+HIDDEN bool putTarHeader(const char * name, size_t plen, const struct stat * st, char type);
 
 // StrToWord is duplicated here from utility.cc to avoid full utility.o linking
 HIDDEN bool StrToWord(const char * str, Word * value);
@@ -127,7 +143,10 @@ HIDDEN void showHelp(const char * prgName)
 	fprintf(stderr, "\twt = avg. write time (microsecs.)\t[1..%u]\t(default = %u)\n", MAXWTIME, flashDfl[WTIME]);
 	fprintf(stderr, "\t<flashfile> = flash dev. image file name\t\t(example = %s%s)\n", flashDflFName, MPSFILETYPE);
 	fprintf(stderr, "\t<file> = file to be written\n");
-	fprintf(stderr, "\tnote: use /dev/null as <file> to create an empty image file\n\n");
+	fprintf(stderr, "\tnote: use /dev/null as <file> to create an empty image file\n");
+	fprintf(stderr, "\n%s -f <flashfile>%s --import-dir <dir> [blocks [wt]]\n", prgName, MPSFILETYPE);
+	fprintf(stderr, "where:\n\t<dir> = directory tree to be stored as a tar archive\n");
+	fprintf(stderr, "\tnote: image files are created sparse; empty blocks take no disk space\n\n");
 }
 
 
@@ -175,7 +194,8 @@ HIDDEN int mkDisk(int argc, char * argv[])
 // This function builds a flash device image file from a data file passed as
 // command line argument, putting geometry and performance figures (by default
 // or passed as command line arguments) in file header. The data file is split
-// into BLOCKSIZE blocks.
+// into BLOCKSIZE blocks. With --import-dir, a whole host directory tree is
+// laid out into the flash device blocks instead (see importDir()).
 // Returns an EXIT_SUCCESS/FAILURE code
 HIDDEN int mkFlash(int argc, char * argv[])
 {
@@ -183,7 +203,11 @@ HIDDEN int mkFlash(int argc, char * argv[])
 	bool error = false;
 	int ret = EXIT_SUCCESS;
 
-	if (argc < 4 || argc > 6 || strstr(argv[2], MPSFILETYPE) == NULL)
+	// index of the first optional parameter
+	bool import = (argc > 3 && SAMESTRING("--import-dir", argv[3]));
+	int first = import ? 5 : 4;
+
+	if (argc < first || argc > first + FLASHPNUM || strstr(argv[2], MPSFILETYPE) == NULL)
 	{
 		// too many or too few args
 		fprintf(stderr, "%s : flash device image file parameters wrong/missing\n", argv[0]);
@@ -191,24 +215,20 @@ HIDDEN int mkFlash(int argc, char * argv[])
 	}
 	else
 	{
-		// start argument decoding
-		if (argc == 4)
-			// all by default: build file image
-			ret = writeFlash(argv[0], argv[2], argv[3]);
-		else
+		// scan args (if any) and places them in flashDfl[]
+		for (i = 0; i < argc - first && !error; i++)
+			error = decodeFlashP(i, &(flashDfl[i]), argv[i + first]);
+		if (error)
 		{
-			// scan args and places them in flashDfl[]
-			for (i = 0; i < argc - 4 && !error; i++)
-				error = decodeFlashP(i, &(flashDfl[i]), argv[i + 4]);
-			if (!error)
-				// build file images
-				ret = writeFlash(argv[0], argv[2], argv[3]);
-			else
-			{
-				fprintf(stderr, "%s : flash device image file parameters wrong/missing\n", argv[0]);
-				ret = EXIT_FAILURE;
-			}
+			fprintf(stderr, "%s : flash device image file parameters wrong/missing\n", argv[0]);
+			ret = EXIT_FAILURE;
 		}
+		else if (import)
+			// build file image from directory tree
+			ret = importDir(argv[0], argv[2], argv[4]);
+		else
+			// build file image
+			ret = writeFlash(argv[0], argv[2], argv[3]);
 	}
 	return(ret);
 }
@@ -326,22 +346,17 @@ HIDDEN bool decodeFlashP(int idx, unsigned int * par, const char * str)
 
 // This function creates the disk image file on the disk, prepending it with
 // a header containing geometry and performance figures.
-// A number of 4096-byte empty blocks is created, depending on disk geometry.
+// Room for a number of 4096-byte empty blocks is made, depending on disk
+// geometry; blocks are left as holes in a sparse file.
 // Returns an EXIT_SUCCESS/FAILURE code
 HIDDEN int writeDisk(const char * prg, const char * fname)
 {
 	FILE * dfile = NULL;
 	int ret = EXIT_SUCCESS;
 
-	unsigned int i;
 	unsigned int dfsize = diskDfl[CYLNUM] * diskDfl[HEADNUM] * diskDfl[SECTNUM];
-	Word blk[BLOCKSIZE];
 	Word diskid = DISKFILEID;
 
-	// clear block
-	for (i = 0; i < BLOCKSIZE; i++)
-		blk[i] = 0;
-
 	// try to open image file and write header
 	if ((dfile = fopen(fname, "w")) == NULL || \
 	    fwrite((void *) &diskid, WORDLEN, 1, dfile) != 1 || \
@@ -349,10 +364,9 @@ HIDDEN int writeDisk(const char * prg, const char * fname)
 		ret = EXIT_FAILURE;
 	else
 	{
-		// write empty blocks
-		for (i = 0; i < dfsize && ret != EXIT_FAILURE; i++)
-			if (fwrite((void *) blk, WORDLEN, BLOCKSIZE, dfile) != BLOCKSIZE)
-				ret = EXIT_FAILURE;
+		// extend file over empty blocks
+		if (finishImage(dfile, DISKPNUM + 1, dfsize))
+			ret = EXIT_FAILURE;
 		if (fclose(dfile) != 0)
 			ret = EXIT_FAILURE;
 	}
@@ -399,30 +413,28 @@ HIDDEN int writeFlash(const char * prg, const char * fname, const char * file)
 			// .alignment reasons
 			testForCore(rfile);
 
-			for (j = 0; j < ffsize && ret != EXIT_FAILURE; j++) {
-				// split file into blocks inside the flash device image
-				if (!feof(rfile)) {
-					// read block from input file
-					if (fread((void *) blk, WORDLEN, BLOCKSIZE, rfile) != BLOCKSIZE)
-						if (ferror(rfile))
-							ret = EXIT_FAILURE;
-
-					// write block to output file
-					if (fwrite((void *) blk, WORDLEN, BLOCKSIZE, ffile) != BLOCKSIZE)
+			// split file into blocks inside the flash device image
+			for (j = 0; j < ffsize && !feof(rfile) && ret != EXIT_FAILURE; j++) {
+				// read block from input file
+				if (fread((void *) blk, WORDLEN, BLOCKSIZE, rfile) != BLOCKSIZE)
+					if (ferror(rfile))
 						ret = EXIT_FAILURE;
 
-					// clear block
-					for (i = 0; i < BLOCKSIZE; i++)
-						blk[i] = 0UL;
-				} else {
-					// write empty block
-					if (fwrite((void *) blk, WORDLEN, BLOCKSIZE, ffile) != BLOCKSIZE)
-						ret = EXIT_FAILURE;
-				}
+				// write block to output file
+				if (putBlock(ffile, blk))
+					ret = EXIT_FAILURE;
+
+				// clear block
+				for (i = 0; i < BLOCKSIZE; i++)
+					blk[i] = 0UL;
 			}
 			if (!feof(rfile))
 				fprintf(stderr, "%s : error writing flash device file image %s : file %s truncated\n", prg, fname, file);
 			fclose(rfile);
+
+			// remaining blocks are empty
+			if (ret != EXIT_FAILURE && finishImage(ffile, FLASHPNUM + 1, ffsize))
+				ret = EXIT_FAILURE;
 		}
 		// try to close flash device image file
 		if (fclose(ffile) != 0)
@@ -436,6 +448,284 @@ HIDDEN int writeFlash(const char * prg, const char * fname, const char * file)
 }
 
 
+// State of the directory import in progress: nftw() offers no way to pass
+// it along to importEntry(), so it is kept at module level
+HIDDEN FILE * impFile = NULL;
+HIDDEN size_t impRootLen = 0;
+HIDDEN Word impBlk[BLOCKSIZE];
+HIDDEN size_t impFill = 0;
+HIDDEN unsigned int impBlocks = 0;
+HIDDEN bool impFull = false;
+
+// tar archive record size
+#define TARRECSIZE	512
+
+// This function creates the flash device image file on the disk, prepending it with
+// a header containing geometry and performance figures, and fills it with a
+// POSIX ustar archive of the directory tree rooted at dir. The archive is
+// streamed straight into the flash device blocks in a single pass, so no
+// intermediate file is needed; the guest finds it starting at block 0.
+// Only regular files and directories are archived; anything else is skipped
+// with a warning.
+// Returns an EXIT_SUCCESS/FAILURE code
+HIDDEN int importDir(const char * prg, const char * fname, const char * dir)
+{
+	// zeroes, for the archive end records and the last block padding
+	char trailer[BLOCKSIZE * WORDLEN];
+	Word flashid = FLASHFILEID;
+	int ret = EXIT_SUCCESS;
+	struct stat st;
+
+	if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode))
+	{
+		fprintf(stderr, "%s : %s is not a directory\n", prg, dir);
+		return(EXIT_FAILURE);
+	}
+
+	impRootLen = strlen(dir);
+	while (impRootLen > 1 && dir[impRootLen - 1] == '/')
+		impRootLen--;
+	impFill = 0;
+	impBlocks = 0;
+	impFull = false;
+
+	// tries to open image file and write header
+	if ((impFile = fopen(fname, "w")) == NULL || \
+	    fwrite((void *) &flashid, WORDLEN, 1, impFile) != 1 || \
+	    fwrite((void *) flashDfl, sizeof(unsigned int), FLASHPNUM, impFile) != FLASHPNUM)
+		ret = EXIT_FAILURE;
+	else
+	{
+		memset(trailer, 0, sizeof(trailer));
+
+		// archive the tree, close it with two empty records and pad the
+		// last block with zeroes
+		if (nftw(dir, importEntry, 16, FTW_PHYS) != 0 || \
+		    putBytes(trailer, 2 * TARRECSIZE) || \
+		    (impFill > 0 && putBytes(trailer, BLOCKSIZE * WORDLEN - impFill)) || \
+		    finishImage(impFile, FLASHPNUM + 1, flashDfl[BLOCKSNUM]))
+			ret = EXIT_FAILURE;
+
+		// try to close flash device image file
+		if (fclose(impFile) != 0)
+			ret = EXIT_FAILURE;
+	}
+	impFile = NULL;
+
+	if (impFull)
+		fprintf(stderr, "%s : error writing flash device file image %s : directory %s does not fit in %u blocks\n",
+		        prg, fname, dir, flashDfl[BLOCKSNUM]);
+	else if (ret == EXIT_FAILURE)
+		fprintf(stderr, "%s : error writing flash device file image %s : %s\n", prg, fname, strerror(errno));
+
+	return(ret);
+}
+
+
+// This function is the nftw() callback of importDir(): it appends a single
+// directory entry to the archive.
+// Returns 0 to keep the walk going, -1 to stop it
+HIDDEN int importEntry(const char * path, const struct stat * st, int flag, struct FTW * ftw)
+{
+	FILE * rfile;
+	char buf[BLOCKSIZE * WORDLEN];
+	char name[PATH_MAX + 1];
+	size_t plen, len, done;
+
+	// tree root is implicit
+	if (ftw->level == 0)
+		return(0);
+
+	// archive member names are relative to tree root
+	snprintf(name, sizeof(name), "%s%s", path + impRootLen + 1, flag == FTW_D ? "/" : "");
+
+	if (splitTarName(name, &plen))
+	{
+		fprintf(stderr, "warning : %s skipped (name too long)\n", path);
+		return(0);
+	}
+
+	if (flag == FTW_D)
+		return(putTarHeader(name, plen, st, '5') ? -1 : 0);
+
+	if (flag != FTW_F || !S_ISREG(st->st_mode))
+	{
+		fprintf(stderr, "warning : %s skipped (not a regular file or directory)\n", path);
+		return(0);
+	}
+
+	if ((rfile = fopen(path, "r")) == NULL)
+	{
+		fprintf(stderr, "warning : %s skipped (%s)\n", path, strerror(errno));
+		return(0);
+	}
+
+	if (putTarHeader(name, plen, st, '0'))
+	{
+		fclose(rfile);
+		return(-1);
+	}
+
+	// copy file contents, then pad to a whole record
+	done = 0;
+	while (done < (size_t) st->st_size && (len = fread(buf, 1, sizeof(buf), rfile)) > 0)
+	{
+		if (len > (size_t) st->st_size - done)
+			len = (size_t) st->st_size - done;
+		if (putBytes(buf, len))
+		{
+			fclose(rfile);
+			return(-1);
+		}
+		done += len;
+	}
+	fclose(rfile);
+
+	// file shrunk while reading: keep the archive consistent with header
+	memset(buf, 0, sizeof(buf));
+	while (done < (size_t) st->st_size)
+	{
+		len = (size_t) st->st_size - done < sizeof(buf) ? (size_t) st->st_size - done : sizeof(buf);
+		if (putBytes(buf, len))
+			return(-1);
+		done += len;
+	}
+
+	if (done % TARRECSIZE != 0 && putBytes(buf, TARRECSIZE - done % TARRECSIZE))
+		return(-1);
+
+	return(0);
+}
+
+
+// This function finds where a member name has to be split between the
+// prefix and name fields of a ustar header: names longer than 100 chars
+// need a separator leaving at most 155 chars of prefix and 100 of name.
+// The prefix length (0 if no split is needed) is returned in plen.
+// Returns TRUE if the name cannot be stored, FALSE otherwise
+HIDDEN bool splitTarName(const char * name, size_t * plen)
+{
+	size_t i, len = strlen(name);
+
+	*plen = 0;
+	if (len <= 100)
+		return(false);
+
+	for (i = 0; i + 1 < len && i <= 155; i++)
+		if (name[i] == '/' && len - i - 1 <= 100)
+		{
+			*plen = i;
+			return(false);
+		}
+	return(true);
+}
+
+
+// This function appends a ustar header record for the named entry to the
+// archive, splitting the name after its first plen chars (see
+// splitTarName()).
+// Returns TRUE if an error occurred, FALSE otherwise
+HIDDEN bool putTarHeader(const char * name, size_t plen, const struct stat * st, char type)
+{
+	char hdr[TARRECSIZE];
+	const char * base = (plen > 0 ? name + plen + 1 : name);
+	unsigned int i, sum;
+
+	memset(hdr, 0, sizeof(hdr));
+	memcpy(hdr + 345, name, plen);
+	memcpy(hdr, base, strlen(base));
+	snprintf(hdr + 100, 8, "%07o", (unsigned int) (st->st_mode & 07777));
+	snprintf(hdr + 108, 8, "%07o", (unsigned int) (st->st_uid & 07777777));
+	snprintf(hdr + 116, 8, "%07o", (unsigned int) (st->st_gid & 07777777));
+	snprintf(hdr + 124, 12, "%011llo", type == '0' ? (unsigned long long) st->st_size : 0ULL);
+	snprintf(hdr + 136, 12, "%011llo", (unsigned long long) st->st_mtime & 077777777777ULL);
+	hdr[156] = type;
+	memcpy(hdr + 257, "ustar", 6);
+	memcpy(hdr + 263, "00", 2);
+
+	// checksum is computed with its own field filled with blanks
+	memset(hdr + 148, ' ', 8);
+	for (i = 0, sum = 0; i < TARRECSIZE; i++)
+		sum += (unsigned char) hdr[i];
+	snprintf(hdr + 148, 8, "%06o", sum);
+
+	return(putBytes(hdr, TARRECSIZE));
+}
+
+
+// This function appends len bytes to the archive being imported, writing
+// out each flash device block as soon as it is filled.
+// Returns TRUE if an error occurred (including running out of blocks),
+// FALSE otherwise
+HIDDEN bool putBytes(const void * data, size_t len)
+{
+	const unsigned char * src = (const unsigned char *) data;
+	size_t chunk;
+
+	while (len > 0)
+	{
+		chunk = BLOCKSIZE * WORDLEN - impFill;
+		if (chunk > len)
+			chunk = len;
+		memcpy((unsigned char *) impBlk + impFill, src, chunk);
+		impFill += chunk;
+		src += chunk;
+		len -= chunk;
+
+		if (impFill == BLOCKSIZE * WORDLEN)
+		{
+			if (impBlocks >= flashDfl[BLOCKSNUM])
+			{
+				impFull = true;
+				return(true);
+			}
+			if (putBlock(impFile, impBlk))
+				return(true);
+			impBlocks++;
+			impFill = 0;
+		}
+	}
+	return(false);
+}
+
+
+// This function tells whether a block is made of zeroes only.
+// Returns TRUE if so, FALSE otherwise
+HIDDEN bool isZeroBlock(const Word * blk)
+{
+	unsigned int i;
+
+	for (i = 0; i < BLOCKSIZE; i++)
+		if (blk[i] != 0UL)
+			return(false);
+	return(true);
+}
+
+
+// This function writes a block at the current position of an image file;
+// empty blocks are skipped over instead, leaving a hole in the file.
+// Returns TRUE if an error occurred, FALSE otherwise
+HIDDEN bool putBlock(FILE * ofile, const Word * blk)
+{
+	if (isZeroBlock(blk))
+		return(fseek(ofile, BLOCKSIZE * WORDLEN, SEEK_CUR) != 0);
+	else
+		return(fwrite((void *) blk, WORDLEN, BLOCKSIZE, ofile) != BLOCKSIZE);
+}
+
+
+// This function sets the final size of an image file made of a header of
+// hdrWords words followed by a number of blocks; whatever has not been
+// written explicitly reads back as zeroes without taking up disk space.
+// Returns TRUE if an error occurred, FALSE otherwise
+HIDDEN bool finishImage(FILE * ofile, unsigned int hdrWords, unsigned int blocks)
+{
+	off_t size = ((off_t) hdrWords + (off_t) blocks * BLOCKSIZE) * WORDLEN;
+
+	return(fflush(ofile) != 0 || ftruncate(fileno(ofile), size) != 0);
+}
+
+
 // This function tests if file to be inserted is a .core file; if so the
 // magic file tag should be skipped for alignment reasons, else file should
 // be inserted as-is
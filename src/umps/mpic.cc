@@ -26,6 +26,8 @@
 #include "umps/machine_config.h"
 #include "umps/systembus.h"
 #include "umps/processor.h"
+#include "umps/irq_latency.h"
+#include "umps/timeline_recorder.h"
 
 using namespace boost::placeholders;
 
@@ -33,8 +35,18 @@ InterruptController::InterruptController(const MachineConfig* config, SystemBus*
 	: config(config),
 	bus(bus),
 	arbiter(0),
-	cpuData(config->getNumProcessors())
+	cpuData(config->getNumProcessors()),
+	latency(NULL),
+	timeline(NULL)
 {
+	// All cpus are halted until reset
+	idleCpus = 0;
+	haltedCpus = ~CpuSet(0);
+
+	for (CpuSet& bucket : priorityBucket)
+		bucket = 0;
+	for (unsigned int i = 0; i < cpuData.size(); i++)
+		priorityBucket[cpuData[i].taskPriority] |= CpuSet(1) << i;
 }
 
 void InterruptController::StartIRQ(unsigned int il, unsigned int devNo)
@@ -48,16 +60,10 @@ void InterruptController::StartIRQ(unsigned int il, unsigned int devNo)
 	if (source.route.policy == IRT_POLICY_FIXED) {
 		if (source.route.destination < cpuData.size())
 			target = source.route.destination;
+	} else if (source.route.policy == IRT_POLICY_LOAD) {
+		target = routeByLoad(source);
 	} else {
-		for (size_t i = 0; i < cpuData.size(); i++) {
-			Word id = (arbiter + i) % cpuData.size();
-			if (source.route.destination & (1U << id)) {
-				if (target == kInvalidCpuId || cpuData[id].taskPriority > cpuData[target].taskPriority)
-					target = id;
-			}
-		}
-		if (target != kInvalidCpuId)
-			arbiter = (target + 1) % cpuData.size();
+		target = routeByPriority(source.route.targets);
 	}
 
 	// No further work to do if no valid target cpu was found;
@@ -65,7 +71,11 @@ void InterruptController::StartIRQ(unsigned int il, unsigned int devNo)
 	if (target == kInvalidCpuId)
 		return;
 
-	source.lastTarget = target;
+	source.lastTarget = source.affinity = target;
+	if (latency != NULL)
+		latency->Request(kBaseIL + il, devNo, target, bus->getToD());
+	if (timeline != NULL)
+		timeline->Interrupt(kBaseIL + il, devNo, target);
 	cpuData[target].ipMask |= 1U << (kBaseIL + il);
 
 	// For shared int. lines, also set the appropriate bit in the
@@ -76,6 +86,57 @@ void InterruptController::StartIRQ(unsigned int il, unsigned int devNo)
 	bus->AssertIRQ(kBaseIL + il, target);
 }
 
+void InterruptController::SetCpuStatus(Word cpuId, bool idle, bool halted)
+{
+	const CpuSet cpuBit = CpuSet(1) << cpuId;
+
+	idleCpus = idle ? (idleCpus | cpuBit) : (idleCpus & ~cpuBit);
+	haltedCpus = halted ? (haltedCpus | cpuBit) : (haltedCpus & ~cpuBit);
+}
+
+// Pick the cpu to deliver to among candidates, the first one from the
+// arbiter on
+Word InterruptController::arbitrate(CpuSet candidates)
+{
+	CpuSet next = candidates & (~CpuSet(0) << arbiter);
+	Word target = __builtin_ctzll(next ? next : candidates);
+
+	arbiter = (target + 1) % cpuData.size();
+	return target;
+}
+
+Word InterruptController::routeByPriority(CpuSet targets)
+{
+	// Pick a cpu in the highest nonempty priority bucket
+	for (int p = kNumPriorities - 1; p >= 0; p--) {
+		CpuSet candidates = targets & priorityBucket[p];
+		if (candidates)
+			return arbitrate(candidates);
+	}
+	return kInvalidCpuId;
+}
+
+// Load-aware routing prefers cpus waiting for interrupts, as they can
+// take them right away, and never picks halted ones. A sticky source
+// stays with the cpu which took its last interrupt, unless that one is
+// busy while others are idle.
+Word InterruptController::routeByLoad(const Source& source)
+{
+	CpuSet targets = source.route.targets & ~haltedCpus;
+	CpuSet idleTargets = targets & idleCpus;
+
+	if (source.route.sticky && source.affinity != kInvalidCpuId) {
+		const CpuSet affinityBit = CpuSet(1) << source.affinity;
+		if ((targets & affinityBit) && (!idleTargets || (idleTargets & affinityBit)))
+			return source.affinity;
+	}
+
+	if (idleTargets)
+		return arbitrate(idleTargets);
+	else
+		return routeByPriority(targets);
+}
+
 void InterruptController::EndIRQ(unsigned int il, unsigned int devNo)
 {
 	il -= kBaseIL;
@@ -87,6 +148,9 @@ void InterruptController::EndIRQ(unsigned int il, unsigned int devNo)
 	if (target == kInvalidCpuId)
 		return;
 
+	if (latency != NULL)
+		latency->Ack(kBaseIL + il, devNo, bus->getToD());
+
 	// Deassert IP signals and IDB bits
 	if (il >= kSharedILBase) {
 		cpuData[target].idb[il - kSharedILBase] &= ~(1U << devNo);
@@ -112,7 +176,10 @@ Word InterruptController::Read(Word addr, const Processor* cpu) const
 		unsigned int il = offset / N_DEV_PER_IL;
 		unsigned int slot = offset % N_DEV_PER_IL;
 		const Source& s = sources[il][slot];
-		return s.route.destination | (s.route.policy << IRT_ENTRY_POLICY_BIT);
+		return (s.route.destination |
+		        (s.route.group << IRT_ENTRY_GROUP_BIT) |
+		        (s.route.policy << IRT_ENTRY_POLICY_BIT) |
+		        (s.route.sticky << IRT_ENTRY_STICKY_BIT));
 	}
 
 	if (CPUCTL_BASE <= addr && addr < CPUCTL_END) {
@@ -120,9 +187,9 @@ Word InterruptController::Read(Word addr, const Processor* cpu) const
 
 		switch (addr) {
 		case CPUCTL_INBOX:
-			if (!cd.ipiInbox.empty()) {
-				IpiMessage ipi = cd.ipiInbox.front();
-				return ipi.msg | (ipi.origin << CPUCTL_INBOX_ORIGIN_BIT);
+			if (cd.ipiCount) {
+				unsigned int origin = cd.ipiOrder[cd.ipiHead];
+				return cd.ipiMsg[origin] | (origin << CPUCTL_INBOX_ORIGIN_BIT);
 			} else {
 				return 0;
 			}
@@ -136,6 +203,14 @@ Word InterruptController::Read(Word addr, const Processor* cpu) const
 		case CPUCTL_BIOS_RES_1:
 			return cd.biosReserved[1];
 
+		case CPUCTL_PERF_CYCLES:
+		case CPUCTL_PERF_INSTRS:
+		case CPUCTL_PERF_TLB_REFILLS:
+		case CPUCTL_PERF_EXCEPTIONS:
+		case CPUCTL_PERF_INTERRUPTS:
+		case CPUCTL_PERF_IDLE:
+			return (Word) cpu->getPerfCounter((PerfCounter) ((addr - CPUCTL_PERF_BASE) >> 2));
+
 		default:
 			return 0;
 		}
@@ -155,15 +230,19 @@ void InterruptController::Write(Word addr, Word data, const Processor* cpu)
 		unsigned int slot = offset % N_DEV_PER_IL;
 		Source& s = sources[il][slot];
 		s.route.destination = IRT_ENTRY_GET_DEST(data);
+		s.route.group = IRT_ENTRY_GET_GROUP(data);
 		s.route.policy = IRT_ENTRY_GET_POLICY(data);
+		s.route.sticky = IRT_ENTRY_GET_STICKY(data);
+		s.route.targets = (CpuSet(s.route.destination) << (s.route.group * kCpusPerGroup));
 	} else if (CPUCTL_BASE <= addr && addr < CPUCTL_END) {
 		CpuData& cd = cpuData[cpu->Id()];
 
 		switch (addr) {
 		case CPUCTL_INBOX:
-			if (!cd.ipiInbox.empty()) {
-				cd.ipiInbox.pop_front();
-				if (cd.ipiInbox.empty()) {
+			if (cd.ipiCount) {
+				cd.ipiPending &= ~(CpuSet(1) << cd.ipiOrder[cd.ipiHead]);
+				cd.ipiHead = (cd.ipiHead + 1) % MachineConfig::MAX_CPUS;
+				if (--cd.ipiCount == 0) {
 					cd.ipMask &= ~(1U << IL_IPI);
 					bus->DeassertIRQ(IL_IPI, cpu->Id());
 				}
@@ -176,7 +255,7 @@ void InterruptController::Write(Word addr, Word data, const Processor* cpu)
 			break;
 
 		case CPUCTL_TPR:
-			cd.taskPriority = data & CPUCTL_TPR_PRIORITY_MASK;
+			setTaskPriority(cpu->Id(), data & CPUCTL_TPR_PRIORITY_MASK);
 			break;
 
 		case CPUCTL_BIOS_RES_0:
@@ -195,25 +274,36 @@ void InterruptController::Write(Word addr, Word data, const Processor* cpu)
 
 void InterruptController::deliverIPI(unsigned int origin, Word outbox)
 {
-	Word recipients = CPUCTL_OUTBOX_GET_RECIP(outbox);
-
-	for (unsigned int i = 0; i < config->getNumProcessors(); i++) {
-		if (recipients & (1U << i)) {
-			bool hasSlot = true;
-			for (const IpiMessage& ipi : cpuData[i].ipiInbox) {
-				if (ipi.origin == origin) {
-					hasSlot = false;
-					break;
-				}
-			}
-			if (hasSlot) {
-				IpiMessage ipi;
-				ipi.origin = origin;
-				ipi.msg = CPUCTL_OUTBOX_GET_MSG(outbox);
-				cpuData[i].ipiInbox.push_back(ipi);
-				cpuData[i].ipMask |= 1U << IL_IPI;
-				bus->AssertIRQ(IL_IPI, i);
-			}
+	CpuSet recipients = (CpuSet(CPUCTL_OUTBOX_GET_RECIP(outbox))
+	                     << (CPUCTL_OUTBOX_GET_GROUP(outbox) * kCpusPerGroup));
+	if (cpuData.size() < MachineConfig::MAX_CPUS)
+		recipients &= (CpuSet(1) << cpuData.size()) - 1;
+
+	const CpuSet originBit = CpuSet(1) << origin;
+
+	while (recipients) {
+		unsigned int i = __builtin_ctzll(recipients);
+		recipients &= recipients - 1;
+
+		CpuData& cd = cpuData[i];
+		if (!(cd.ipiPending & originBit)) {
+			cd.ipiPending |= originBit;
+			cd.ipiMsg[origin] = CPUCTL_OUTBOX_GET_MSG(outbox);
+			cd.ipiOrder[(cd.ipiHead + cd.ipiCount) % MachineConfig::MAX_CPUS] = origin;
+			cd.ipiCount++;
+			cd.ipMask |= 1U << IL_IPI;
+			bus->AssertIRQ(IL_IPI, i);
+			if (timeline != NULL)
+				timeline->IPI(origin, i);
 		}
 	}
 }
+
+void InterruptController::setTaskPriority(unsigned int cpuId, unsigned int priority)
+{
+	CpuData& cd = cpuData[cpuId];
+
+	priorityBucket[cd.taskPriority] &= ~(CpuSet(1) << cpuId);
+	priorityBucket[priority] |= CpuSet(1) << cpuId;
+	cd.taskPriority = priority;
+}
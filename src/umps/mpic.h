@@ -21,7 +21,6 @@
 #ifndef UMPS_MPIC_H
 #define UMPS_MPIC_H
 
-#include <deque>
 #include <vector>
 
 #include "umps/machine_config.h"
@@ -29,6 +28,8 @@
 
 class SystemBus;
 class Processor;
+class InterruptLatency;
+class TimelineRecorder;
 
 class InterruptController {
 public:
@@ -46,18 +47,44 @@ Word GetIP(Word cpuId) const {
 	return cpuData[cpuId].ipMask << CAUSE_IP_BIT(0);
 }
 
+// Keep track of which cpus are idle (waiting for interrupts) or
+// halted, for load-aware routing
+void SetCpuStatus(Word cpuId, bool idle, bool halted);
+
+// Report requests and acks to latency (NULL to stop reporting)
+void setLatency(InterruptLatency* latency) {
+	this->latency = latency;
+}
+
+// Report interrupt requests and IPIs to timeline (NULL to stop
+// reporting)
+void setTimeline(TimelineRecorder* timeline) {
+	this->timeline = timeline;
+}
+
 private:
 static const unsigned int kBaseIL = 2;
 static const unsigned int kSharedILBase = 1;
 
 static const Word kInvalidCpuId = ~0U;
 
+static const unsigned int kCpusPerGroup = 16;
+static const unsigned int kNumPriorities = CPUCTL_TPR_PRIORITY_MASK + 1;
+
+typedef uint64_t CpuSet;
+static_assert(MachineConfig::MAX_CPUS <= sizeof(CpuSet) * 8,
+              "CpuSet too small for MachineConfig::MAX_CPUS");
+
 struct Source {
 	Source()
-		: lastTarget(kInvalidCpuId)
+		: lastTarget(kInvalidCpuId),
+		  affinity(kInvalidCpuId)
 	{
 		route.destination = 0;
+		route.group = 0;
 		route.policy = IRT_POLICY_FIXED;
+		route.sticky = 0;
+		route.targets = 0;
 	}
 
 	// Core the last interrupt from this source was delivered to, needed
@@ -65,18 +92,21 @@ struct Source {
 	// change at any time.
 	Word lastTarget;
 
-	// IRT entry fields
+	// Core the last interrupt from this source was delivered to, whether
+	// acked or not, for sticky load-aware routing
+	Word affinity;
+
+	// IRT entry fields, and the set of cpus the destination field
+	// stands for under dynamic routing
 	struct {
-		unsigned destination : MachineConfig::MAX_CPUS;
-		unsigned policy      : 1;
+		Word destination;
+		Word group;
+		Word policy;
+		Word sticky;
+		CpuSet targets;
 	} route;
 };
 
-struct IpiMessage {
-	unsigned origin : 4;
-	unsigned msg : 8;
-};
-
 struct CpuData {
 	CpuData()
 	{
@@ -84,16 +114,31 @@ struct CpuData {
 		for (Word& data : idb)
 			data = 0;
 		taskPriority = CPUCTL_TPR_PRIORITY_MASK;
+		ipiPending = 0;
+		ipiHead = ipiCount = 0;
 	}
 
 	Word ipMask;
 	Word idb[N_EXT_IL];
-	std::deque<IpiMessage> ipiInbox;
 	unsigned int taskPriority;
 	Word biosReserved[2];
+
+	// IPI inbox: at most one message per origin cpu may be pending,
+	// so the inbox is a bitmap of origins with a message slot each,
+	// plus a ring keeping origins in arrival order
+	CpuSet ipiPending;
+	uint8_t ipiMsg[MachineConfig::MAX_CPUS];
+	uint8_t ipiOrder[MachineConfig::MAX_CPUS];
+	unsigned int ipiHead;
+	unsigned int ipiCount;
 };
 
+Word routeByPriority(CpuSet targets);
+Word routeByLoad(const Source& source);
+Word arbitrate(CpuSet candidates);
+
 void deliverIPI(unsigned int origin, Word outbox);
+void setTaskPriority(unsigned int cpuId, unsigned int priority);
 
 const MachineConfig* const config;
 SystemBus* const bus;
@@ -102,11 +147,22 @@ SystemBus* const bus;
 // destinations with equal task priorities
 unsigned int arbiter;
 
+// Cpus by task priority, so that dynamic routing only needs to
+// look at one bucket per priority level
+CpuSet priorityBucket[kNumPriorities];
+
+// Cpus waiting for interrupts and halted cpus
+CpuSet idleCpus;
+CpuSet haltedCpus;
+
 // Incoming int. sources
 Source sources[N_EXT_IL + 1][N_DEV_PER_IL];
 
 // Int. controller cpu interface, for each core
 std::vector<CpuData> cpuData;
+
+InterruptLatency* latency;
+TimelineRecorder* timeline;
 };
 
 #endif // UMPS_MPIC_H
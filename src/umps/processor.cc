@@ -44,6 +44,11 @@
 #include "umps/machine_config.h"
 #include "umps/error.h"
 #include "umps/disassemble.h"
+#include "umps/trace_recorder.h"
+#include "umps/callgraph_profiler.h"
+#include "umps/tlb_stats.h"
+#include "umps/irq_latency.h"
+#include "umps/timeline_recorder.h"
 
 
 // Names of exceptions
@@ -204,8 +209,15 @@ Processor::Processor(const MachineConfig* config, Word cpuId, Machine* machine,
 	status(PS_HALTED),
 	tlbSize(config->getTLBSize()),
 	tlb(new TLBEntry[tlbSize]),
-	tlbFloorAddress(config->getTLBFloorAddress())
+	tlbFloorAddress(config->getTLBFloorAddress()),
+	tracer(NULL),
+	callGraph(NULL),
+	timeline(NULL),
+	tlbStats(NULL),
+	irqLatency(NULL),
+	stallCycles(0)
 {
+	resetCounters();
 }
 
 Processor::~Processor() {
@@ -229,6 +241,11 @@ void Processor::Reset(Word pc, Word sp)
 	// first instruction is not in a branch delay slot
 	isBranchD = false;
 
+	// no memory stall pending
+	stallCycles = 0;
+
+	resetCounters();
+
 	// no exception pending at start
 	excCause = NOEXCEPTION;
 	copENum = 0;
@@ -271,6 +288,18 @@ void Processor::Reset(Word pc, Word sp)
 	setStatus(PS_RUNNING);
 }
 
+// This method clears performance counters and cycle accounting
+void Processor::resetCounters()
+{
+	for (unsigned int i = 0; i < N_PERF_COUNTERS; i++)
+		perfCounters[i] = 0;
+
+	for (unsigned int asid = 0; asid < MAXASID; asid++)
+		modeCycles[asid][0] = modeCycles[asid][1] = 0;
+	handlerCycles = 0;
+	inHandler = false;
+}
+
 void Processor::Halt()
 {
 	setStatus(PS_HALTED);
@@ -297,6 +326,8 @@ void Processor::Cycle()
 	if (isHalted())
 		return;
 
+	perfCounters[PERF_CYCLES]++;
+
 	// Update internal timer
 	if (cpreg[STATUS] & STATUS_TE) {
 		if (cpreg[CP0REG_TIMER] == 0)
@@ -307,17 +338,45 @@ void Processor::Cycle()
 	}
 
 	// In low-power state, only the per-cpu timer keeps running
-	if (isIdle())
+	if (isIdle()) {
+		perfCounters[PERF_IDLE_CYCLES]++;
+		return;
+	}
+
+	modeCycles[getASID()][InUserMode()]++;
+	if (inHandler)
+		handlerCycles++;
+
+	// Waiting for a cache miss to be served
+	if (stallCycles > 0) {
+		stallCycles--;
 		return;
+	}
+
+	if (tracer != NULL) {
+		tracedPC = currPC;
+		tracedInstr = currInstr;
+		tracedASID = getASID();
+		tracedUser = InUserMode();
+		tracedExc = -1;
+	}
+
+	if (callGraph != NULL)
+		callGraph->Execute(id, bus->getToD(), currPC, currInstr, getASID(), InUserMode());
 
 	// Instruction decode & exec
 	if (execInstr(currInstr))
 		handleExc();
+	else
+		perfCounters[PERF_INSTRUCTIONS]++;
 
 	// Check if we entered sleep mode as a result of the last
 	// instruction; if so, we effectively stall the pipeline.
-	if (isIdle())
+	if (isIdle()) {
+		if (tracer != NULL)
+			traceRetire();
 		return;
+	}
 
 	// PC saving for book-keeping purposes
 	prevPC = currPC;
@@ -348,6 +407,9 @@ void Processor::Cycle()
 		currInstr = NOP;
 		handleExc();
 	}
+
+	if (tracer != NULL)
+		traceRetire();
 }
 
 uint32_t Processor::IdleCycles() const
@@ -365,6 +427,8 @@ void Processor::Skip(uint32_t cycles)
 	assert(isIdle() && cycles <= IdleCycles());
 	if (cpreg[STATUS] & STATUS_TE)
 		cpreg[CP0REG_TIMER] -= cycles;
+	perfCounters[PERF_CYCLES] += cycles;
+	perfCounters[PERF_IDLE_CYCLES] += cycles;
 }
 
 // This method allows SystemBus and Processor itself to signal Processor
@@ -503,6 +567,29 @@ Word Processor::getTLBLo(unsigned int index) const
 	return tlb[index].getLO();
 }
 
+// This method translates vaddr the way mapVirtual() does for a load,
+// without signaling anything: it is meant for inspection (e.g. stack
+// walking by profilers)
+bool Processor::TranslateAddress(Word vaddr, Word * paddr)
+{
+	unsigned int index;
+
+	if (BADADDR(vaddr) || (InUserMode() && INBOUNDS(vaddr, KSEG0BASE, KUSEGBASE)))
+		return true;
+
+	if (INBOUNDS(vaddr, KSEG0BASE, tlbFloorAddress)) {
+		*paddr = vaddr;
+		return false;
+	}
+
+	if (probeTLB(&index, cpreg[ENTRYHI], vaddr) && tlb[index].IsV()) {
+		*paddr = PHADDR(vaddr, tlb[index].getLO());
+		return false;
+	}
+
+	return true;
+}
+
 // This method allows to modify the current value of a general purpose
 // register (HI and LO are the last ones in the array)
 void Processor::setGPR(unsigned int num, SWord val)
@@ -650,6 +737,22 @@ void Processor::handleExc()
 	// set the excCode into CAUSE reg
 	cpreg[CAUSE] = IM(cpreg[CAUSE]) | (excCode[excCause] << CAUSE_EXCCODE_BIT);
 
+	if (tracer != NULL)
+		tracedExc = excCode[excCause];
+
+	inHandler = true;
+
+	if (excCause == INTEXCEPTION) {
+		perfCounters[PERF_INTERRUPTS]++;
+		if (irqLatency != NULL)
+			irqLatency->Taken(id, (cpreg[CAUSE] & cpreg[STATUS] & CAUSE_IP_MASK) >> CAUSE_IP_BIT(0),
+			                  bus->getToD());
+	} else if (excCause == UTLBLEXCEPTION || excCause == UTLBSEXCEPTION) {
+		perfCounters[PERF_TLB_REFILLS]++;
+	} else {
+		perfCounters[PERF_EXCEPTIONS]++;
+	}
+
 	if (isBranchD) {
 		// previous instr. is branch/jump: must restart from it
 		cpreg[CAUSE] = SetBit(cpreg[CAUSE], CAUSE_BD_BIT);
@@ -661,6 +764,11 @@ void Processor::handleExc()
 		cpreg[EPC] = currPC;
 	}
 
+	if (callGraph != NULL)
+		callGraph->Exception(id, cpreg[EPC]);
+	if (timeline != NULL)
+		timeline->Exception(id, excName[excCause]);
+
 	// Set coprocessor unusable number in CAUSE register for
 	// `Coprocessor Unusable' exceptions
 	if (excCause == CPUEXCEPTION)
@@ -697,6 +805,14 @@ void Processor::handleExc()
 	}
 }
 
+// This method hands the instruction executed in the current cycle over
+// to the tracer
+void Processor::traceRetire()
+{
+	tracer->Record(id, bus->getToD(), tracedPC, tracedInstr,
+	               tracedASID, tracedUser, tracedExc);
+}
+
 // This method zeroes out the TLB
 void Processor::zapTLB()
 {
@@ -817,6 +933,8 @@ bool Processor::mapVirtual(Word vaddr, Word * paddr, Word accType)
 			} else {
 				// write operation on frame with D bit set to 0
 				*paddr = MAXWORDVAL;
+				if (tlbStats != NULL)
+					tlbStats->Fault(getASID(), vaddr, TLB_EVENT_MOD);
 				setTLBRegs(vaddr);
 				SignalExc(MODEXCEPTION);
 				return true;
@@ -824,6 +942,8 @@ bool Processor::mapVirtual(Word vaddr, Word * paddr, Word accType)
 		} else  {
 			// invalid access to frame with V bit set to 0
 			*paddr = MAXWORDVAL;
+			if (tlbStats != NULL)
+				tlbStats->Fault(getASID(), vaddr, TLB_EVENT_INVALID);
 			setTLBRegs(vaddr);
 			if (accType == WRITE)
 				SignalExc(TLBSEXCEPTION);
@@ -835,6 +955,8 @@ bool Processor::mapVirtual(Word vaddr, Word * paddr, Word accType)
 	} else {
 		// bad or missing VPN match: Refill event required
 		*paddr = MAXWORDVAL;
+		if (tlbStats != NULL)
+			tlbStats->Fault(getASID(), vaddr, TLB_EVENT_REFILL);
 		setTLBRegs(vaddr);
 		if (accType == WRITE)
 			SignalExc(UTLBSEXCEPTION);
@@ -924,6 +1046,9 @@ bool Processor::execInstr(Word instr)
 					switch(FUNCT(instr)) {
 					case RFE:
 						popKUIEStack();
+						inHandler = false;
+						if (timeline != NULL)
+							timeline->ExceptionReturn(id);
 						break;
 
 					case TLBP:
@@ -939,12 +1064,20 @@ bool Processor::execInstr(Word instr)
 						break;
 
 					case TLBWI:
+						if (tlbStats != NULL)
+							tlbStats->Write(getASID(), false,
+							                tlb[RNDIDX(cpreg[INDEX])].getHI(),
+							                tlb[RNDIDX(cpreg[INDEX])].IsV());
 						tlb[RNDIDX(cpreg[INDEX])].setHI(cpreg[ENTRYHI]);
 						tlb[RNDIDX(cpreg[INDEX])].setLO(cpreg[ENTRYLO]);
 						SignalTLBChanged(RNDIDX(cpreg[INDEX]));
 						break;
 
 					case TLBWR:
+						if (tlbStats != NULL)
+							tlbStats->Write(getASID(), true,
+							                tlb[RNDIDX(cpreg[RANDOM])].getHI(),
+							                tlb[RNDIDX(cpreg[RANDOM])].IsV());
 						tlb[RNDIDX(cpreg[RANDOM])].setHI(cpreg[ENTRYHI]);
 						tlb[RNDIDX(cpreg[RANDOM])].setLO(cpreg[ENTRYLO]);
 						SignalTLBChanged(RNDIDX(cpreg[INDEX]));
@@ -32,6 +32,11 @@ class MachineConfig;
 class Machine;
 class SystemBus;
 class TLBEntry;
+class TraceRecorder;
+class CallGraphProfiler;
+class TLBStats;
+class InterruptLatency;
+class TimelineRecorder;
 
 enum ProcessorStatus {
 	PS_HALTED,
@@ -39,6 +44,17 @@ enum ProcessorStatus {
 	PS_IDLE
 };
 
+// Performance counters, in the order of CPUCTL_PERF_* registers
+enum PerfCounter {
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_TLB_REFILLS,
+	PERF_EXCEPTIONS,
+	PERF_INTERRUPTS,
+	PERF_IDLE_CYCLES,
+	N_PERF_COUNTERS
+};
+
 class Processor {
 public:
 // Register file size:
@@ -84,6 +100,32 @@ uint32_t IdleCycles() const;
 
 void Skip(uint32_t cycles);
 
+// This method makes Processor skip its next cycles, as if waiting
+// for memory (see CacheModel)
+void Stall(Word cycles) {
+	stallCycles += cycles;
+}
+
+// This method returns a performance counter: cycles since reset
+// (idle ones and memory stalls included), instructions retired, TLB
+// refills, exceptions taken (refills and interrupts excluded),
+// interrupts taken, idle cycles
+uint64_t getPerfCounter(PerfCounter counter) const {
+	return perfCounters[counter];
+}
+
+// These methods return where cycles went since reset: cycles run in
+// kernel or user mode by each ASID (memory stalls included), and
+// cycles spent in exception handlers, from exception entry to the
+// next RFE (e.g. the one ending a BIOS LDST); idle cycles are
+// counted by PERF_IDLE_CYCLES
+uint64_t getModeCycles(Word asid, bool user) const {
+	return modeCycles[asid][user];
+}
+uint64_t getHandlerCycles() const {
+	return handlerCycles;
+}
+
 // This method allows SystemBus and Processor itself to signal
 // Processor when an exception happens. SystemBus signal IBE/DBE
 // exceptions; Processor itself signal all other kinds of exception.
@@ -123,6 +165,11 @@ void getTLB(unsigned int index, Word * hi, Word * lo) const;
 Word getTLBHi(unsigned int index) const;
 Word getTLBLo(unsigned int index) const;
 
+// This method maps vaddr to *paddr as a load by the current process
+// would, but with no side effects (no exception, no CP0 changes);
+// returns TRUE if vaddr is not mapped to a valid frame
+bool TranslateAddress(Word vaddr, Word * paddr);
+
 // The following methods allow to change Processor internal status
 // Name & parameters are almost self-explanatory: remember that
 // all addresses are _virtual_ when not marked Phys/P/phys (for
@@ -138,6 +185,33 @@ void setTLB(unsigned int index, Word hi, Word lo);
 void setTLBHi(unsigned int index, Word value);
 void setTLBLo(unsigned int index, Word value);
 
+// Record executed instructions through tracer (NULL to stop tracing)
+void setTracer(TraceRecorder* tracer) {
+	this->tracer = tracer;
+}
+
+// Report executed instructions and exceptions to the call graph
+// profiler (NULL to stop profiling)
+void setCallGraphProfiler(CallGraphProfiler* profiler) {
+	callGraph = profiler;
+}
+
+// Report exception handler entries and returns to timeline (NULL to
+// stop reporting)
+void setTimeline(TimelineRecorder* timeline) {
+	this->timeline = timeline;
+}
+
+// Report interrupt exceptions to latency (NULL to stop reporting)
+void setInterruptLatency(InterruptLatency* latency) {
+	irqLatency = latency;
+}
+
+// Count TLB faults and writes in stats (NULL to stop counting)
+void setTLBStats(TLBStats* stats) {
+	tlbStats = stats;
+}
+
 // Signals
 sigc::signal<void> StatusChanged;
 sigc::signal<void, unsigned int> SignalException;
@@ -217,10 +291,40 @@ scoped_array<TLBEntry> tlb;
 
 Word tlbFloorAddress;
 
+// instruction tracing: the instruction being executed, as it was
+// before execution, and the code of the exception it caused (if any)
+TraceRecorder* tracer;
+Word tracedPC;
+Word tracedInstr;
+Word tracedASID;
+bool tracedUser;
+int tracedExc;
+
+CallGraphProfiler* callGraph;
+
+TimelineRecorder* timeline;
+
+TLBStats* tlbStats;
+
+InterruptLatency* irqLatency;
+
+// cycles left to wait for memory
+Word stallCycles;
+
+uint64_t perfCounters[N_PERF_COUNTERS];
+
+// cycle accounting, by ASID and kernel (0) or user (1) mode
+uint64_t modeCycles[MAXASID][2];
+uint64_t handlerCycles;
+bool inHandler;
+
+void resetCounters();
+
 // private methods
 void setStatus(ProcessorStatus newStatus);
 
 void handleExc();
+void traceRetire();
 void zapTLB(void);
 
 bool execInstr(Word instr);
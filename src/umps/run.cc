@@ -0,0 +1,347 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * This is a stand-alone program which runs a machine without the
+ * graphical interface, from power on until it halts (or for a given
+ * number of cycles), as fast as the host allows: idle periods are
+ * skipped at once instead of being waited for in real time. Device
+ * output goes to the files set in the machine configuration.
+ *
+ * On exit, a summary of where cycles went, interrupt latency
+ * histograms, the most contended locks, device I/O statistics and
+ * the simulation speed can be printed.
+ *
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libgen.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include <umps/const.h>
+#include "base/lang.h"
+#include "umps/types.h"
+#include "umps/error.h"
+#include "umps/machine_config.h"
+#include "umps/machine.h"
+#include "umps/processor.h"
+#include "umps/stoppoint.h"
+#include "umps/systembus.h"
+#include "umps/device.h"
+#include "umps/irq_latency.h"
+#include "umps/lock_stats.h"
+#include "umps/symbol_table.h"
+
+// Cycles run by each Machine::step() call
+HIDDEN const unsigned int kIterCycles = 100000;
+
+// Cycles an idle machine with no device activity can go on before it
+// is taken as stuck: longer than any timer, so that each has expired
+HIDDEN const uint64_t kStuckCycles = (uint64_t) 1 << 33;
+
+// Locks listed by the contention report
+HIDDEN const size_t kTopLocks = 20;
+
+// Device class names, by interrupt line
+HIDDEN const char* const devClassName[] = {
+	"Disk", "Flash", "Network", "Printer", "Terminal"
+};
+
+HIDDEN void showHelp(const char * prgName);
+HIDDEN int runMachine(const char * prgName, const char * configName,
+                      uint64_t maxCycles, bool summary, bool latency, bool locks,
+                      bool devices, bool perf);
+HIDDEN void printCycleSummary(const Machine * machine, uint64_t cycles);
+HIDDEN void printDeviceStats(Machine * machine, uint64_t cycles);
+HIDDEN void printRunSpeed(Machine * machine, unsigned int numCpus, uint64_t cycles, double seconds);
+HIDDEN uint64_t instructionsRetired(Machine * machine, unsigned int numCpus);
+
+// This function scans the line arguments; if no error is found, the
+// machine is run, or a warning/help message is printed.
+// Returns an EXIT_SUCCESS/FAILURE code
+int main(int argc, char * argv[])
+{
+	uint64_t maxCycles = 0;
+	bool summary = false;
+	bool latency = false;
+	bool locks = false;
+	bool devices = false;
+	bool perf = false;
+	int ret = EXIT_SUCCESS;
+	int i;
+
+	if (argc == 1) {
+		showHelp(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// scan line arguments
+	for (i = 1; i < argc - 1 && ret != EXIT_FAILURE; i++)
+	{
+		if (SAMESTRING("-c", argv[i]) && i < argc - 2)
+			maxCycles = strtoull(argv[++i], NULL, 0);
+		else
+		if (SAMESTRING("-s", argv[i]))
+			summary = true;
+		else
+		if (SAMESTRING("-i", argv[i]))
+			latency = true;
+		else
+		if (SAMESTRING("-l", argv[i]))
+			locks = true;
+		else
+		if (SAMESTRING("-d", argv[i]))
+			devices = true;
+		else
+		if (SAMESTRING("-p", argv[i]))
+			perf = true;
+		else
+			// unrecognized option
+			ret = EXIT_FAILURE;
+	}
+
+	if (ret == EXIT_FAILURE) {
+		showHelp(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	return runMachine(argv[0], argv[argc - 1], maxCycles, summary, latency, locks, devices, perf);
+}
+
+// Guest or simulator fatal errors end the run
+void Panic(const char* message)
+{
+	fprintf(stderr, "PANIC: %s\n", message);
+	exit(EXIT_FAILURE);
+}
+
+// This function prints a warning/help message on standard error
+HIDDEN void showHelp(const char * prgName)
+{
+	fprintf(stderr, "%s syntax : %s [-c <cycles>] [-s] [-i] [-l] [-d] [-p] <configfile>\n\n", prgName, prgName);
+	fprintf(stderr, "where:\n\n-c\tstop after <cycles> cycles if the machine has not halted yet\n");
+	fprintf(stderr, "-s\tprint a summary of cycles by ASID and mode on exit\n");
+	fprintf(stderr, "-i\tprint interrupt latency histograms on exit\n");
+	fprintf(stderr, "-l\tprint the most contended CAS locations on exit\n");
+	fprintf(stderr, "-d\tprint device I/O statistics on exit\n");
+	fprintf(stderr, "-p\tprint instructions retired and host MIPS on exit\n\n");
+}
+
+// This function loads the machine configuration and runs the machine
+// until it halts or maxCycles (if not 0) have elapsed. Returns an
+// EXIT_SUCCESS/FAILURE code: running out of cycles is a failure, as is
+// getting stuck idle with nothing left that could wake the machine
+HIDDEN int runMachine(const char * prgName, const char * configName,
+                      uint64_t maxCycles, bool summary, bool latency, bool locks,
+                      bool devices, bool perf)
+{
+	std::string error;
+	scoped_ptr<MachineConfig> config(MachineConfig::LoadFromFile(configName, error));
+	if (!config) {
+		fprintf(stderr, "%s : Error loading %s : %s\n", prgName, configName, error.c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::list<std::string> errors;
+	if (!config->Validate(&errors)) {
+		for (const std::string& e : errors)
+			fprintf(stderr, "%s : %s : %s\n", prgName, configName, e.c_str());
+		return EXIT_FAILURE;
+	}
+
+	// Paths in the configuration are relative to its directory
+	std::string configPath(configName);
+	if (chdir(dirname(&configPath[0])) < 0) {
+		fprintf(stderr, "%s : Error : cannot access the directory of %s\n", prgName, configName);
+		return EXIT_FAILURE;
+	}
+
+	StoppointSet breakpoints, suspects, tracepoints;
+	scoped_ptr<Machine> machine;
+	try {
+		machine.reset(new Machine(config.get(), &breakpoints, &suspects, &tracepoints));
+	} catch (const Error& e) {
+		fprintf(stderr, "%s : Error : %s\n", prgName, e.what());
+		return EXIT_FAILURE;
+	}
+
+	SystemBus* bus = machine->getBus();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	uint64_t quietSince = 0;
+	uint64_t lastInstructions = 0;
+	bool stuck = false;
+	while (!machine->IsHalted() && (maxCycles == 0 || bus->getToD() < maxCycles)) {
+		uint64_t left = maxCycles ? maxCycles - bus->getToD() : (uint64_t) -1;
+		uint32_t idle = machine->idleCycles();
+		if (!bus->DevicesIdle())
+			quietSince = bus->getToD();
+		if (idle > 0)
+			machine->skip((uint32_t) std::min((uint64_t) idle, left));
+		else
+			machine->step((unsigned int) std::min((uint64_t) kIterCycles, left));
+
+		uint64_t instructions = instructionsRetired(machine.get(), config->getNumProcessors());
+		if (instructions != lastInstructions) {
+			lastInstructions = instructions;
+			quietSince = bus->getToD();
+		}
+		// Only the timers are left to wake the machine: if it slept
+		// through all of them, their interrupts reach no processor
+		if (bus->getToD() - quietSince > kStuckCycles) {
+			stuck = true;
+			break;
+		}
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	uint64_t cycles = bus->getToD();
+	bool halted = machine->IsHalted();
+
+	if (summary)
+		printCycleSummary(machine.get(), cycles);
+	if (latency) {
+		printf("%sInterrupt latency (cycles):\n", summary ? "\n" : "");
+		machine->getInterruptLatency()->WriteReport(stdout);
+	}
+	if (locks) {
+		// Without a symbol table locks are just addresses
+		scoped_ptr<SymbolTable> stab;
+		try {
+			stab.reset(new SymbolTable(config->getSymbolTableASID(),
+			                           config->getROM(ROM_TYPE_STAB).c_str()));
+		} catch (const Error& e) {
+			stab.reset();
+		}
+		printf("%sLock contention:\n", summary || latency ? "\n" : "");
+		machine->getLockStats()->WriteReport(stdout, stab.get(), kTopLocks);
+	}
+	if (devices) {
+		printf("%sDevice I/O:\n", summary || latency || locks ? "\n" : "");
+		printDeviceStats(machine.get(), cycles);
+	}
+	if (perf) {
+		printf("%sSimulation speed:\n", summary || latency || locks || devices ? "\n" : "");
+		printRunSpeed(machine.get(), config->getNumProcessors(), cycles, elapsed.count());
+	}
+
+	// Destroying the machine writes profiles and flushes device output
+	machine.reset();
+
+	if (stuck) {
+		fprintf(stderr, "%s : machine idle with nothing pending after %llu cycles\n",
+		        prgName, (unsigned long long) cycles);
+		return EXIT_FAILURE;
+	}
+	if (!halted) {
+		fprintf(stderr, "%s : machine still running after %llu cycles\n",
+		        prgName, (unsigned long long) cycles);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+// This function prints where cycles of all cpus went, as a table of
+// ASIDs followed by idle and exception handler totals
+HIDDEN void printCycleSummary(const Machine * machine, uint64_t cycles)
+{
+	std::vector<Machine::CycleAccount> accounts = machine->getCycleAccounts();
+	uint64_t idle = machine->getIdleCycles();
+
+	uint64_t total = idle;
+	for (const Machine::CycleAccount& a : accounts)
+		total += a.kernel + a.user;
+	double scale = total > 0 ? 100.0 / total : 0.0;
+
+	printf("Machine cycles: %llu\n\n", (unsigned long long) cycles);
+	printf("%-8s %16s %16s %16s %7s\n", "ASID", "Kernel", "User", "Total", "%");
+	for (const Machine::CycleAccount& a : accounts) {
+		printf("%-8u %16llu %16llu %16llu %6.2f%%\n", a.asid,
+		       (unsigned long long) a.kernel, (unsigned long long) a.user,
+		       (unsigned long long) (a.kernel + a.user), (a.kernel + a.user) * scale);
+	}
+	printf("%-8s %16s %16s %16llu %6.2f%%\n", "idle", "", "",
+	       (unsigned long long) idle, idle * scale);
+	printf("\nIn exception handlers: %llu (%.2f%%)\n",
+	       (unsigned long long) machine->getHandlerCycles(), machine->getHandlerCycles() * scale);
+}
+
+// This function prints the I/O counters of each device which received
+// commands, followed by seek and rotation histograms for disks
+HIDDEN void printDeviceStats(Machine * machine, uint64_t cycles)
+{
+	double scale = cycles > 0 ? 100.0 / cycles : 0.0;
+
+	printf("%-12s %10s %8s %12s %16s %7s %12s\n",
+	       "Device", "Commands", "Errors", "DMA bytes", "Busy", "%", "Avg queue");
+	for (unsigned int il = 0; il < N_EXT_IL; il++) {
+		for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++) {
+			Device* dev = machine->getDevice(il, devNo);
+			const DeviceStats& st = dev->getStats();
+			if (st.commands == 0)
+				continue;
+
+			char name[16];
+			snprintf(name, sizeof(name), "%s %u", devClassName[il], devNo);
+			printf("%-12s %10llu %8llu %12llu %16llu %6.2f%% %12.1f\n", name,
+			       (unsigned long long) st.commands, (unsigned long long) st.errors,
+			       (unsigned long long) st.dmaBytes, (unsigned long long) st.busyCycles,
+			       st.busyCycles * scale,
+			       st.queueWaits > 0 ? (double) st.queueCycles / st.queueWaits : 0.0);
+		}
+	}
+
+	for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++) {
+		DiskDevice* disk = dynamic_cast<DiskDevice*>(machine->getDevice(EXT_IL_INDEX(IL_DISK), devNo));
+		if (disk == NULL || disk->getSeekDistances().count + disk->getRotationalLatencies().count == 0)
+			continue;
+		printf("\nDisk %u\n", devNo);
+		disk->getSeekDistances().Write(stdout, "seek (cyl)");
+		disk->getRotationalLatencies().Write(stdout, "rotation");
+	}
+}
+
+// This function prints the instructions retired by all cpus and how
+// fast the host ran them; the lines are meant to be easy to parse for
+// benchmark scripts
+HIDDEN void printRunSpeed(Machine * machine, unsigned int numCpus, uint64_t cycles, double seconds)
+{
+	uint64_t instructions = instructionsRetired(machine, numCpus);
+
+	printf("Machine cycles: %llu\n", (unsigned long long) cycles);
+	printf("Instructions: %llu\n", (unsigned long long) instructions);
+	printf("Host time: %.3f s\n", seconds);
+	printf("Host MIPS: %.2f\n", seconds > 0 ? instructions / seconds / 1e6 : 0.0);
+}
+
+// This function returns the instructions retired by all cpus so far
+HIDDEN uint64_t instructionsRetired(Machine * machine, unsigned int numCpus)
+{
+	uint64_t instructions = 0;
+	for (unsigned int i = 0; i < numCpus; i++)
+		instructions += machine->getProcessor(i)->getPerfCounter(PERF_INSTRUCTIONS);
+	return instructions;
+}
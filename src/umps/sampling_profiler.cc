@@ -0,0 +1,190 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "umps/sampling_profiler.h"
+
+#include <algorithm>
+
+#include <boost/bind/bind.hpp>
+
+#include "umps/arch.h"
+#include "umps/const.h"
+#include "umps/disassemble.h"
+#include "umps/error.h"
+#include "umps/machine.h"
+#include "umps/processor.h"
+#include "umps/symbol_table.h"
+#include "umps/systembus.h"
+
+using namespace boost::placeholders;
+
+// Register numbers and instruction patterns used by unwind()
+#define REG_SP 29
+#define REG_RA 31
+
+#define OP_MASK             0xFFFF0000UL
+#define OP_ADDIU_SP_SP      0x27BD0000UL
+#define OP_SW_RA_SP         0xAFBF0000UL
+
+SamplingProfiler::SamplingProfiler(const MachineConfig* config, Machine* machine)
+	: interval(config->getSamplingInterval()),
+	  machine(machine),
+	  numCpus(config->getNumProcessors()),
+	  fileName(config->getSamplingFile())
+{
+	file = fopen(fileName.c_str(), "w");
+	if (file == NULL)
+		throw FileError(fileName);
+
+	// Without a symbol table frames are just addresses
+	try {
+		stab.reset(new SymbolTable(config->getSymbolTableASID(),
+		                           config->getROM(ROM_TYPE_STAB).c_str()));
+	} catch (const Error& e) {
+		stab.reset();
+	}
+
+	machine->getBus()->scheduleEvent(interval, boost::bind(&SamplingProfiler::sample, this));
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+	for (const auto& s : stacks)
+		fprintf(file, "%s %llu\n", s.first.c_str(), (unsigned long long) s.second);
+	fclose(file);
+}
+
+void SamplingProfiler::sample()
+{
+	Word frames[kMaxDepth];
+
+	for (unsigned int i = 0; i < numCpus; i++) {
+		Processor* cpu = machine->getProcessor(i);
+		if (cpu->isHalted())
+			continue;
+
+		std::string stack;
+		if (cpu->isIdle()) {
+			stack = "[idle]";
+		} else {
+			Word asid = cpu->getASID();
+			if (cpu->InUserMode())
+				stack = "[user:" + std::to_string(asid) + "]";
+			else
+				stack = "[kernel]";
+
+			for (unsigned int n = unwind(cpu, frames); n > 0; n--)
+				stack += ";" + frameName(asid, frames[n - 1]);
+		}
+		stacks[stack]++;
+	}
+
+	machine->getBus()->scheduleEvent(interval, boost::bind(&SamplingProfiler::sample, this));
+}
+
+// This method fills frames with the pc of cpu and the return sites of
+// its callers, innermost first, and returns their number. The caller
+// of each function is found by scanning the function prologue up to
+// the current pc of the frame for the usual gcc sequence
+//
+//     addiu $sp, $sp, -size
+//     sw    $ra, offset($sp)
+//
+// which gives the frame size and the slot holding the saved $ra; a
+// function not saving $ra (yet) can only be the innermost one, so
+// that its caller is in the $ra register.
+unsigned int SamplingProfiler::unwind(Processor* cpu, Word* frames)
+{
+	Word tableASID = MAXASID;
+	unsigned int n = 0;
+
+	frames[n++] = cpu->getPC();
+	if (stab == NULL)
+		return n;
+	if (stab->getASID() != MAXASID) {
+		tableASID = cpu->getASID();
+		if (tableASID != stab->getASID())
+			return n;
+	}
+
+	Word sp = cpu->getGPR(REG_SP);
+	while (n < kMaxDepth) {
+		Word pc = frames[n - 1];
+		const Symbol* func = stab->Probe(tableASID, pc, false);
+		if (func == NULL)
+			break;
+
+		Word size = 0;
+		SWord raOffset = -1;
+		Word end = std::min(pc, func->getStart() + kMaxPrologue * WS);
+		for (Word addr = func->getStart(); addr < end; addr += WS) {
+			Word instr;
+			if (readWord(cpu, addr, &instr))
+				return n;
+			if ((instr & OP_MASK) == OP_ADDIU_SP_SP && SignExtImm(instr) < 0)
+				size = -SignExtImm(instr);
+			else if ((instr & OP_MASK) == OP_SW_RA_SP)
+				raOffset = SignExtImm(instr);
+		}
+
+		Word ra;
+		if (raOffset >= 0) {
+			if (readWord(cpu, sp + raOffset, &ra))
+				break;
+		} else if (n == 1) {
+			ra = cpu->getGPR(REG_RA);
+		} else {
+			break;
+		}
+		sp += size;
+
+		// Return to the call site (ra points past the delay slot)
+		if (ra < 2 * WS)
+			break;
+		frames[n++] = ra - 2 * WS;
+	}
+
+	return n;
+}
+
+// This method reads a word of the address space of cpu, without side
+// effects; returns TRUE if vaddr is not mapped to memory
+bool SamplingProfiler::readWord(Processor* cpu, Word vaddr, Word* data)
+{
+	Word paddr;
+
+	if (cpu->TranslateAddress(vaddr, &paddr) || INBOUNDS(paddr, MMIO_BASE, MMIO_END))
+		return true;
+	return machine->ReadMemory(paddr, data);
+}
+
+std::string SamplingProfiler::frameName(Word asid, Word pc) const
+{
+	const Symbol* func = NULL;
+
+	if (stab != NULL)
+		func = stab->Probe(stab->getASID() == MAXASID ? MAXASID : asid, pc, false);
+	if (func != NULL)
+		return func->getName();
+
+	char buf[16];
+	snprintf(buf, sizeof(buf), "0x%.8X", pc);
+	return buf;
+}
@@ -0,0 +1,80 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef UMPS_SAMPLING_PROFILER_H
+#define UMPS_SAMPLING_PROFILER_H
+
+#include <stdio.h>
+
+#include <map>
+#include <string>
+
+#include "base/lang.h"
+#include "umps/machine_config.h"
+
+class Machine;
+class Processor;
+class SymbolTable;
+
+/*
+ * SamplingProfiler periodically samples what every cpu of a machine
+ * is executing, as configured in MachineConfig, and writes the
+ * profile when destroyed, in the "folded stacks" format understood
+ * by flamegraph tools: one line per distinct call stack, with frames
+ * from the outermost to the innermost separated by ';', followed by
+ * the number of samples.
+ *
+ * Call stacks are recovered heuristically, from $ra and from the
+ * function prologues found through the symbol table (see unwind()),
+ * so they may be truncated; they are never longer than kMaxDepth.
+ */
+class SamplingProfiler {
+public:
+	SamplingProfiler(const MachineConfig* config, Machine* machine);
+	~SamplingProfiler();
+
+private:
+	static const unsigned int kMaxDepth = 16;
+
+	// Prologue instructions scanned while unwinding a frame
+	static const unsigned int kMaxPrologue = 32;
+
+	void sample();
+	unsigned int unwind(Processor* cpu, Word* frames);
+	bool readWord(Processor* cpu, Word vaddr, Word* data);
+	std::string frameName(Word asid, Word pc) const;
+
+	const unsigned int interval;
+
+	Machine* const machine;
+	const unsigned int numCpus;
+
+	std::string fileName;
+	FILE* file;
+
+	scoped_ptr<SymbolTable> stab;
+
+	// Sample count of each folded call stack
+	std::map<std::string, uint64_t> stacks;
+
+	DISABLE_COPY_AND_ASSIGNMENT(SamplingProfiler);
+};
+
+#endif // UMPS_SAMPLING_PROFILER_H
@@ -45,6 +45,7 @@
 #include "umps/systembus.h"
 
 #include <assert.h>
+#include <algorithm>
 
 #include "umps/const.h"
 #include "umps/blockdev_params.h"
@@ -62,6 +63,11 @@
 #include "umps/memspace.h"
 #include "umps/event.h"
 #include "umps/mpic.h"
+#include "umps/code_coverage.h"
+#include "umps/memory_heatmap.h"
+#include "umps/cache_model.h"
+#include "umps/lock_stats.h"
+#include "umps/timeline_recorder.h"
 
 // This macro converts a byte address into a word address (minus offset)
 #define CONVERT(ad, bs) ((ad - bs) >> WORDSHIFT)
@@ -110,11 +116,17 @@ SystemBus::SystemBus(const MachineConfig* conf, Machine* machine)
 	: config(conf),
 	machine(machine),
 	pic(new InterruptController(conf, this)),
-	mpController(new MPController(conf, machine))
+	mpController(new MPController(conf, machine)),
+	coverage(NULL),
+	heatmap(NULL),
+	caches(NULL),
+	lockStats(NULL),
+	timeline(NULL)
 {
 	tod = UINT64_C(0);
 	timer = MAXWORDVAL;
 	eventQ = new EventQueue();
+	eventCount = 0;
 
 	const char *coreFile = NULL;
 	if (config->isLoadCoreEnabled())
@@ -175,6 +187,7 @@ void SystemBus::ClockTick()
 	while (!eventQ->IsEmpty() && eventQ->nextDeadline() <= tod) {
 		(eventQ->nextCallback())();
 		eventQ->RemoveHead();
+		eventCount++;
 	}
 }
 
@@ -200,6 +213,35 @@ void SystemBus::Skip(uint32_t cycles)
 	machine->HandleBusAccess(BUS_REG_TIMER, WRITE, NULL);
 }
 
+bool SystemBus::DevicesIdle() const
+{
+	return eventQ->IsEmpty() && inputWaiters.empty();
+}
+
+void SystemBus::WatchHostInput(Device* dev)
+{
+	if (std::find(inputWaiters.begin(), inputWaiters.end(), dev) == inputWaiters.end())
+		inputWaiters.push_back(dev);
+}
+
+void SystemBus::UnwatchHostInput(Device* dev)
+{
+	inputWaiters.erase(std::remove(inputWaiters.begin(), inputWaiters.end(), dev),
+	                   inputWaiters.end());
+}
+
+void SystemBus::PollHostInput()
+{
+	// Devices which got their input (or gave up) leave the set
+	std::vector<Device*>::iterator it = inputWaiters.begin();
+	while (it != inputWaiters.end()) {
+		if ((*it)->PollHostInput())
+			++it;
+		else
+			it = inputWaiters.erase(it);
+	}
+}
+
 void SystemBus::setToDHI(Word hi)
 {
 	TimeStamp::setHi(tod, hi);
@@ -229,6 +271,10 @@ bool SystemBus::DataRead(Word addr, Word* datap, Processor* cpu)
 		return true;
 	}
 
+	if (heatmap != NULL)
+		heatmap->Access(addr, HEATMAP_READ, cpu);
+	if (caches != NULL)
+		caches->Read(addr, cpu);
 	return false;
 }
 
@@ -261,8 +307,13 @@ bool SystemBus::DataWrite(Word addr, Word data, Processor* proc)
 		// data write is out of valid write bounds
 		proc->SignalExc(DBEXCEPTION);
 		return true;
-	} else
-		return false;
+	}
+
+	if (heatmap != NULL)
+		heatmap->Access(addr, HEATMAP_WRITE, proc);
+	if (caches != NULL)
+		caches->Write(addr, proc);
+	return false;
 }
 
 bool SystemBus::CompareAndSet(Word addr, Word oldval, Word newval, bool* result, Processor* cpu)
@@ -271,6 +322,19 @@ bool SystemBus::CompareAndSet(Word addr, Word oldval, Word newval, bool* result,
 	// ISA, is required to fail for I/O locations.
 	if (RAMBASE <= addr && addr < RAMBASE + ram->Size()) {
 		*result = ram->CompareAndSet((addr - RAMBASE) >> 2, oldval, newval);
+		if (lockStats != NULL)
+			lockStats->CompareAndSet(addr, *result, cpu->getId(), tod);
+		if (heatmap != NULL) {
+			heatmap->Access(addr, HEATMAP_READ, cpu);
+			if (*result)
+				heatmap->Access(addr, HEATMAP_WRITE, cpu);
+		}
+		if (caches != NULL) {
+			if (*result)
+				caches->Write(addr, cpu);
+			else
+				caches->Read(addr, cpu);
+		}
 		return false;
 	} else if (MMIO_BASE <= addr && addr < MMIO_END) {
 		*result = false;
@@ -292,6 +356,11 @@ bool SystemBus::DMATransfer(Block * blk, Word startAddr, bool toMemory)
 
 	bool error = false;
 
+	if (heatmap != NULL)
+		heatmap->DMA(startAddr, BLOCKSIZE);
+	if (caches != NULL && toMemory)
+		caches->DMA(startAddr, BLOCKSIZE);
+
 	if (toMemory) {
 		for (Word ofs = 0; ofs < BLOCKSIZE && !error; ofs++) {
 			error = busWrite(startAddr + (ofs * WORDLEN), blk->getWord(ofs));
@@ -328,6 +397,11 @@ bool SystemBus::DMAVarTransfer(Block* blk, Word startAddr, Word byteLength, bool
 
 	bool error = false;
 
+	if (heatmap != NULL)
+		heatmap->DMA(startAddr, length);
+	if (caches != NULL && toMemory)
+		caches->DMA(startAddr, length);
+
 	if (toMemory) {
 		for (Word ofs = 0; ofs < length && !error; ofs++) {
 			error = busWrite(startAddr + (ofs * WORDLEN), blk->getWord(ofs));
@@ -346,6 +420,46 @@ bool SystemBus::DMAVarTransfer(Block* blk, Word startAddr, Word byteLength, bool
 }
 
 
+// This method transfers byteLength bytes to memory straight from a device
+// buffer of words, starting with address startAddr; it returns TRUE is
+// transfer was not successful (non-existent memory, read-only memory,
+// unaligned addresses), FALSE otherwise.
+// It notifies too the memory accesses to Watch control object
+bool SystemBus::DMAVarTransfer(const Word * buf, Word startAddr, Word byteLength)
+{
+	// fit bytes into words
+	Word length = (byteLength + WORDLEN - 1) / WORDLEN;
+
+	if (BADADDR(startAddr) || length > BLOCKSIZE)
+		return true;
+
+	bool error = false;
+
+	if (heatmap != NULL)
+		heatmap->DMA(startAddr, length);
+	if (caches != NULL)
+		caches->DMA(startAddr, length);
+
+	for (Word ofs = 0; ofs < length && !error; ofs++) {
+		error = busWrite(startAddr + (ofs * WORDLEN), buf[ofs]);
+		machine->HandleBusAccess(startAddr + (ofs * WORDLEN), WRITE, NULL);
+	}
+
+	return error;
+}
+
+
+void SystemBus::setInterruptLatency(InterruptLatency* latency)
+{
+	pic->setLatency(latency);
+}
+
+void SystemBus::setTimeline(TimelineRecorder* timeline)
+{
+	this->timeline = timeline;
+	pic->setTimeline(timeline);
+}
+
 // This method reads a istruction from memory at address addr, returning
 // it thru istrp pointer. It also returns TRUE if the address was invalid and
 // an exception was caused, FALSE otherwise, and notifies Watch
@@ -359,6 +473,12 @@ bool SystemBus::InstrRead(Word addr, Word* instrp, Processor* proc)
 		return true;
 	} else {
 		// address was valid
+		if (coverage != NULL)
+			coverage->Fetch(addr);
+		if (heatmap != NULL)
+			heatmap->Access(addr, HEATMAP_FETCH, proc);
+		if (caches != NULL)
+			caches->Fetch(addr, proc);
 		return false;
 	}
 }
@@ -386,6 +506,18 @@ Word SystemBus::getPendingInt(const Processor* cpu)
 	return pic->GetIP(cpu->Id());
 }
 
+void SystemBus::CpuStatusChanged(const Processor* cpu)
+{
+	pic->SetCpuStatus(cpu->Id(), cpu->isIdle(), cpu->isHalted());
+}
+
+void SystemBus::DeviceStatusChanged(const Device* device)
+{
+	if (timeline != NULL)
+		timeline->DeviceStatus(device->getInterruptLine(), device->getNumber(),
+		                       device->getBusyUnits());
+}
+
 void SystemBus::AssertIRQ(unsigned int il, unsigned int target)
 {
 	machine->getProcessor(target)->AssertIRQ(il);
@@ -559,6 +691,8 @@ bool SystemBus::busWrite(Word addr, Word data, Processor* cpu)
 			DeviceAreaAddress dva(addr);
 			Device* device = devTable[dva.line()][dva.device()];
 			device->WriteDevReg(dva.field(), data);
+			device->AccountRegWrite(dva.field());
+			DeviceStatusChanged(device);
 		} else if (INBOUNDS(addr, IRT_BASE, IRT_END) ||
 		           INBOUNDS(addr, CPUCTL_BASE, CPUCTL_END))
 		{
@@ -22,6 +22,8 @@
 #ifndef UMPS_SYSTEMBUS_H
 #define UMPS_SYSTEMBUS_H
 
+#include <vector>
+
 #include "base/lang.h"
 #include "base/basic_types.h"
 #include "umps/event.h"
@@ -36,6 +38,12 @@ class RamSpace;
 class BiosSpace;
 class Block;
 class MPController;
+class CodeCoverage;
+class MemoryHeatmap;
+class CacheModel;
+class InterruptLatency;
+class LockStats;
+class TimelineRecorder;
 class InterruptController;
 
 class SystemBus {
@@ -54,6 +62,10 @@ public:
 
 	void Skip(uint32_t cycles);
 
+// This method returns TRUE if no device operation is in progress and
+// no device is waiting for host input, FALSE otherwise
+	bool DevicesIdle() const;
+
 // This method reads a data word from memory at physical address
 // addr, returning it thru datap pointer. It also returns TRUE if
 // the address was invalid and an exception was caused, FALSE
@@ -88,8 +100,23 @@ public:
 // control object
 	bool DMAVarTransfer(Block * blk, Word startAddr, Word byteLength, bool toMemory);
 
+// This method transfers byteLength bytes to memory straight from a
+// device buffer of words, starting with address startAddr; it returns
+// TRUE is transfer was not successful, FALSE otherwise. It notifies
+// too the memory accesses to Watch control object
+	bool DMAVarTransfer(const Word * buf, Word startAddr, Word byteLength);
+
 	uint64_t scheduleEvent(uint64_t delay, Event::Callback callback);
 
+// These methods keep the set of devices parked waiting for input from
+// a host source (file, pipe, network): instead of polling it through
+// the event queue, a parked device is asked to check for input by
+// PollHostInput(), and schedules its own completion event as soon as
+// input is there
+	void WatchHostInput(Device* dev);
+	void UnwatchHostInput(Device* dev);
+	void PollHostInput();
+
 // This method sets the appropriate bits into intCauseDev[] and
 // IntPendMask to signal device interrupt pending; it notifies
 // memory changes to Watch too
@@ -106,6 +133,46 @@ public:
 	void AssertIRQ(unsigned int il, unsigned int target);
 	void DeassertIRQ(unsigned int il, unsigned int target);
 
+// This method lets interrupt routing know about a processor status
+// change
+	void CpuStatusChanged(const Processor* cpu);
+
+// This method lets the timeline know about a device starting or
+// completing an operation
+	void DeviceStatusChanged(const Device* device);
+
+// This method makes instruction fetches be recorded by coverage
+// (NULL to stop recording)
+	void setCoverage(CodeCoverage* coverage) {
+		this->coverage = coverage;
+	}
+
+// This method makes memory accesses be counted by heatmap (NULL to
+// stop counting)
+	void setHeatmap(MemoryHeatmap* heatmap) {
+		this->heatmap = heatmap;
+	}
+
+// This method makes memory accesses go thru the simulated caches
+// (NULL to bypass them)
+	void setCaches(CacheModel* caches) {
+		this->caches = caches;
+	}
+
+// This method makes CAS outcomes be counted by lockStats (NULL to
+// stop counting)
+	void setLockStats(LockStats* lockStats) {
+		this->lockStats = lockStats;
+	}
+
+// This method makes device operations, interrupt requests and IPIs
+// be recorded by timeline (NULL to stop recording)
+	void setTimeline(TimelineRecorder* timeline);
+
+// This method makes interrupt requests and acks be timed by latency
+// (NULL to stop timing)
+	void setInterruptLatency(InterruptLatency* latency);
+
 	Machine* getMachine() {
 		return machine;
 	}
@@ -122,10 +189,18 @@ public:
 	Word getToDHI() const {
 		return TimeStamp::getHi(tod);
 	}
+	uint64_t getToD() const {
+		return tod;
+	}
 	Word getTimer() const {
 		return timer;
 	}
 
+// This method returns the number of device events processed so far
+	uint64_t getEventCount() const {
+		return eventCount;
+	}
+
 	void setToDHI(Word hi);
 	void setToDLO(Word lo);
 	void setTimer(Word time);
@@ -150,8 +225,27 @@ private:
 	uint64_t tod;
 	Word timer;
 
+// instruction fetch coverage
+	CodeCoverage* coverage;
+
+// per-frame access counters
+	MemoryHeatmap* heatmap;
+
+// simulated cache hierarchy
+	CacheModel* caches;
+
+// CAS contention counters
+	LockStats* lockStats;
+
+// cpu and device activity recorder
+	TimelineRecorder* timeline;
+
 // device events queue
 	EventQueue * eventQ;
+	uint64_t eventCount;
+
+// devices waiting for host input
+	std::vector<Device*> inputWaiters;
 
 // physical memory spaces
 	RamSpace * ram;
@@ -0,0 +1,212 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/timeline_recorder.h"
+
+#include "umps/error.h"
+#include "umps/machine.h"
+#include "umps/systembus.h"
+
+// Track ids: two per cpu, and one per device unit
+#define CPU_STATUS_TID(cpu)             (2 * (cpu))
+#define CPU_EVENTS_TID(cpu)             (2 * (cpu) + 1)
+#define DEVICE_TID(il, devNo, unit)     (((il) * N_DEV_PER_IL + (devNo)) * kMaxUnits + (unit))
+
+// Span names of cpu states, in ProcessorStatus order
+HIDDEN const char* const statusName[] = {
+	"halted", "running", "idle"
+};
+
+// Track names of devices, by interrupt line
+HIDDEN const char* const deviceName[N_EXT_IL] = {
+	"Disk", "Flash", "Network", "Printer", "Terminal"
+};
+
+TimelineRecorder::TimelineRecorder(const MachineConfig* config, Machine* machine)
+	: machine(machine),
+	  numCpus(config->getNumProcessors()),
+	  clockRate(config->getClockRate()),
+	  fileName(config->getTimelineFile()),
+	  first(true),
+	  cpus(new CpuTrack[config->getNumProcessors()])
+{
+	file = fopen(fileName.c_str(), "w");
+	if (file == NULL)
+		throw FileError(fileName);
+
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	writeMetadata("process_name", kCpuPid, 0, "name", "Processors");
+	writeMetadata("process_name", kDevicePid, 0, "name", "Devices");
+
+	for (unsigned int i = 0; i < numCpus; i++) {
+		std::string name = "CPU " + std::to_string(i);
+		writeMetadata("thread_name", kCpuPid, CPU_STATUS_TID(i), "name", name);
+		writeMetadata("thread_name", kCpuPid, CPU_EVENTS_TID(i), "name", name + " exceptions");
+		cpus[i].status = PS_HALTED;
+		cpus[i].since = 0;
+		cpus[i].exception = NULL;
+	}
+
+	for (unsigned int il = 0; il < N_EXT_IL; il++) {
+		for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++) {
+			devices[il][devNo].busy = 0;
+			devices[il][devNo].named = false;
+		}
+	}
+}
+
+TimelineRecorder::~TimelineRecorder()
+{
+	uint64_t end = now();
+
+	for (unsigned int i = 0; i < numCpus; i++) {
+		writeSpan(statusName[cpus[i].status], kCpuPid, CPU_STATUS_TID(i), cpus[i].since, end);
+		if (cpus[i].exception != NULL)
+			writeSpan(cpus[i].exception, kCpuPid, CPU_EVENTS_TID(i), cpus[i].excSince, end);
+	}
+	for (unsigned int il = 0; il < N_EXT_IL; il++)
+		for (unsigned int devNo = 0; devNo < N_DEV_PER_IL; devNo++)
+			DeviceStatus(il, devNo, 0);
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+}
+
+void TimelineRecorder::CpuStatus(Word cpu, ProcessorStatus status)
+{
+	CpuTrack& t = cpus[cpu];
+	if (status == t.status)
+		return;
+
+	uint64_t time = now();
+	writeSpan(statusName[t.status], kCpuPid, CPU_STATUS_TID(cpu), t.since, time);
+	t.status = status;
+	t.since = time;
+}
+
+void TimelineRecorder::Exception(Word cpu, const char* name)
+{
+	CpuTrack& t = cpus[cpu];
+	if (t.exception != NULL) {
+		// A service asked by the handler (e.g. a BIOS break)
+		writeInstant(name, CPU_EVENTS_TID(cpu));
+	} else {
+		t.exception = name;
+		t.excSince = now();
+	}
+}
+
+void TimelineRecorder::ExceptionReturn(Word cpu)
+{
+	CpuTrack& t = cpus[cpu];
+	if (t.exception != NULL) {
+		writeSpan(t.exception, kCpuPid, CPU_EVENTS_TID(cpu), t.excSince, now());
+		t.exception = NULL;
+	}
+}
+
+void TimelineRecorder::DeviceStatus(unsigned int il, unsigned int devNo, unsigned int busyUnits)
+{
+	DeviceTrack& d = devices[il][devNo];
+	unsigned int changed = d.busy ^ busyUnits;
+	if (!changed)
+		return;
+
+	// Tracks are named on first use, so that idle devices do not
+	// show up
+	if (!d.named) {
+		std::string name = std::string(deviceName[il]) + " " + std::to_string(devNo);
+		if (il == EXT_IL_INDEX(IL_TERMINAL)) {
+			writeMetadata("thread_name", kDevicePid, DEVICE_TID(il, devNo, 0), "name", name + " RX");
+			writeMetadata("thread_name", kDevicePid, DEVICE_TID(il, devNo, 1), "name", name + " TX");
+		} else {
+			writeMetadata("thread_name", kDevicePid, DEVICE_TID(il, devNo, 0), "name", name);
+		}
+		d.named = true;
+	}
+
+	uint64_t time = now();
+	for (unsigned int unit = 0; unit < kMaxUnits; unit++) {
+		unsigned int bit = 1U << unit;
+		if (!(changed & bit))
+			continue;
+		if (busyUnits & bit)
+			d.since[unit] = time;
+		else
+			writeSpan("busy", kDevicePid, DEVICE_TID(il, devNo, unit), d.since[unit], time);
+	}
+	d.busy = busyUnits;
+}
+
+void TimelineRecorder::Interrupt(unsigned int il, unsigned int devNo, Word cpu)
+{
+	if (il == IL_TIMER)
+		writeInstant("IRQ interval timer", CPU_EVENTS_TID(cpu));
+	else
+		writeInstant("IRQ " + std::string(deviceName[EXT_IL_INDEX(il)]) + " " + std::to_string(devNo),
+		             CPU_EVENTS_TID(cpu));
+}
+
+void TimelineRecorder::IPI(Word origin, Word cpu)
+{
+	writeInstant("IPI from CPU " + std::to_string(origin), CPU_EVENTS_TID(cpu));
+}
+
+uint64_t TimelineRecorder::now() const
+{
+	return machine->getBus()->getToD();
+}
+
+// The clock rate is in MHz, that is cycles per microsecond
+double TimelineRecorder::micros(uint64_t cycles) const
+{
+	return cycles / clockRate;
+}
+
+// This method starts writing an event object, up to its timestamp;
+// the caller adds any other field and closes it
+void TimelineRecorder::beginEvent(const char* name, const char* phase, unsigned int pid,
+                                  unsigned int tid, uint64_t ts)
+{
+	fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f",
+	        first ? "" : ",", name, phase, pid, tid, micros(ts));
+	first = false;
+}
+
+void TimelineRecorder::writeSpan(const char* name, unsigned int pid, unsigned int tid,
+                                 uint64_t start, uint64_t end)
+{
+	beginEvent(name, "X", pid, tid, start);
+	fprintf(file, ",\"dur\":%.3f}", micros(end - start));
+}
+
+void TimelineRecorder::writeInstant(const std::string& name, unsigned int tid)
+{
+	beginEvent(name.c_str(), "i", kCpuPid, tid, now());
+	fprintf(file, ",\"s\":\"t\"}");
+}
+
+void TimelineRecorder::writeMetadata(const char* name, unsigned int pid, unsigned int tid,
+                                     const char* argName, const std::string& value)
+{
+	beginEvent(name, "M", pid, tid, 0);
+	fprintf(file, ",\"args\":{\"%s\":\"%s\"}}", argName, value.c_str());
+}
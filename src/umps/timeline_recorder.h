@@ -0,0 +1,113 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_TIMELINE_RECORDER_H
+#define UMPS_TIMELINE_RECORDER_H
+
+#include <stdio.h>
+
+#include <string>
+
+#include "base/lang.h"
+#include "umps/arch.h"
+#include "umps/machine_config.h"
+#include "umps/processor.h"
+
+class Machine;
+
+/*
+ * TimelineRecorder writes the activity of processors and devices, as
+ * configured in MachineConfig, as a Chrome trace-event JSON file (as
+ * understood by chrome://tracing and Perfetto), with timestamps in
+ * microseconds of simulated time.
+ *
+ * Each cpu has two tracks: one with running, idle and halted spans,
+ * and one with exception handler spans (from exception entry to the
+ * RFE, exceptions taken meanwhile being nested services) and instant
+ * events for interrupt requests and IPIs routed to it. Each device
+ * (and each terminal sub-device) has a track with its busy spans,
+ * from the command to the completion of the operation.
+ *
+ * Events are streamed as they happen; spans are written when they
+ * end, and those still open when the recorder is destroyed end then.
+ */
+class TimelineRecorder {
+public:
+	TimelineRecorder(const MachineConfig* config, Machine* machine);
+	~TimelineRecorder();
+
+	void CpuStatus(Word cpu, ProcessorStatus status);
+	void Exception(Word cpu, const char* name);
+	void ExceptionReturn(Word cpu);
+
+	// busyUnits is a bitmap of the busy sub-devices of the device
+	// devNo on interrupt line DEV_IL_START + il
+	void DeviceStatus(unsigned int il, unsigned int devNo, unsigned int busyUnits);
+
+	void Interrupt(unsigned int il, unsigned int devNo, Word cpu);
+	void IPI(Word origin, Word cpu);
+
+private:
+	// Processes grouping tracks
+	static const unsigned int kCpuPid = 1;
+	static const unsigned int kDevicePid = 2;
+	static const unsigned int kMaxUnits = 2;
+
+	struct CpuTrack {
+		ProcessorStatus status;
+		uint64_t since;
+		// Exception handler span, if open
+		const char* exception;
+		uint64_t excSince;
+	};
+
+	struct DeviceTrack {
+		unsigned int busy;
+		uint64_t since[kMaxUnits];
+		bool named;
+	};
+
+	uint64_t now() const;
+	double micros(uint64_t cycles) const;
+
+	void beginEvent(const char* name, const char* phase, unsigned int pid,
+	                unsigned int tid, uint64_t ts);
+	void writeSpan(const char* name, unsigned int pid, unsigned int tid,
+	               uint64_t start, uint64_t end);
+	void writeInstant(const std::string& name, unsigned int tid);
+	void writeMetadata(const char* name, unsigned int pid, unsigned int tid,
+	                   const char* argName, const std::string& value);
+
+	Machine* const machine;
+	const unsigned int numCpus;
+	const double clockRate;
+
+	std::string fileName;
+	FILE* file;
+	bool first;
+
+	scoped_array<CpuTrack> cpus;
+	DeviceTrack devices[N_EXT_IL][N_DEV_PER_IL];
+
+	DISABLE_COPY_AND_ASSIGNMENT(TimelineRecorder);
+};
+
+#endif // UMPS_TIMELINE_RECORDER_H
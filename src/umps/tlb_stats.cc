@@ -0,0 +1,79 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include "umps/tlb_stats.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "umps/cp0.h"
+#include "umps/processor_defs.h"
+
+TLBStats::TLBStats()
+{
+	Reset();
+}
+
+void TLBStats::Fault(Word asid, Word vaddr, TLBEvent event)
+{
+	counters[asid][event]++;
+	pageFaults[VPN(vaddr) | (asid << ENTRYHI_ASID_BIT)]++;
+}
+
+void TLBStats::Write(Word asid, bool random, Word victimHI, bool live)
+{
+	counters[asid][TLB_EVENT_WRITE]++;
+	if (random && live)
+		counters[ENTRYHI_GET_ASID(victimHI)][TLB_EVENT_EVICTION]++;
+}
+
+uint64_t TLBStats::getTotal(TLBEvent event) const
+{
+	uint64_t total = 0;
+	for (Word asid = 0; asid < MAXASID; asid++)
+		total += counters[asid][event];
+	return total;
+}
+
+std::vector<TLBStats::PageFaults> TLBStats::getTopFaults(size_t n) const
+{
+	std::vector<PageFaults> pages;
+	pages.reserve(pageFaults.size());
+	for (const auto& p : pageFaults) {
+		PageFaults pf = { (Word) ENTRYHI_GET_ASID(p.first), (Word) VPN(p.first), p.second };
+		pages.push_back(pf);
+	}
+
+	n = std::min(n, pages.size());
+	std::partial_sort(pages.begin(), pages.begin() + n, pages.end(),
+	                  [](const PageFaults& a, const PageFaults& b) {
+		                  return a.faults > b.faults;
+	                  });
+	pages.resize(n);
+	return pages;
+}
+
+void TLBStats::Reset()
+{
+	memset(counters, 0, sizeof(counters));
+	pageFaults.clear();
+}
@@ -0,0 +1,83 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef UMPS_TLB_STATS_H
+#define UMPS_TLB_STATS_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "base/lang.h"
+#include "umps/const.h"
+#include "umps/types.h"
+
+enum TLBEvent {
+	TLB_EVENT_REFILL,
+	TLB_EVENT_INVALID,
+	TLB_EVENT_MOD,
+	TLB_EVENT_WRITE,
+	TLB_EVENT_EVICTION,
+	N_TLB_EVENTS
+};
+
+/*
+ * TLBStats counts TLB events of all cpus, by ASID: refills (UTLBL
+ * and UTLBS), invalid entry faults (TLBL and TLBS), modification
+ * faults, TLB writes and live entries evicted by TLBWR (charged to
+ * the ASID of the entry evicted). Faults are counted by virtual page
+ * too, so that the pages faulting most can be listed.
+ */
+class TLBStats {
+public:
+	struct PageFaults {
+		Word asid;
+		Word vpn;
+		uint64_t faults;
+	};
+
+	TLBStats();
+
+	// Count a fault of type event (refill, invalid or mod) at vaddr
+	void Fault(Word asid, Word vaddr, TLBEvent event);
+	// Count a TLB write; victimHI is the entry overwritten, live if it
+	// was valid
+	void Write(Word asid, bool random, Word victimHI, bool live);
+
+	uint64_t getCount(Word asid, TLBEvent event) const {
+		return counters[asid][event];
+	}
+	uint64_t getTotal(TLBEvent event) const;
+
+	// The n pages with most faults, most faulting first
+	std::vector<PageFaults> getTopFaults(size_t n) const;
+
+	void Reset();
+
+private:
+	uint64_t counters[MAXASID][N_TLB_EVENTS];
+
+	// Faults by page, keyed by VPN | ASID as in ENTRYHI
+	std::unordered_map<Word, uint64_t> pageFaults;
+
+	DISABLE_COPY_AND_ASSIGNMENT(TLBStats);
+};
+
+#endif // UMPS_TLB_STATS_H
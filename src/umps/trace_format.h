@@ -0,0 +1,119 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Instruction trace file format, shared by TraceRecorder and the
+ * umps3-tracedump utility. All integers are little endian.
+ *
+ * A trace file starts with a header:
+ *
+ *   magic ("UMPT", 4 bytes), version (2 bytes), number of cpus (2 bytes)
+ *
+ * followed by chunks, each one holding consecutive records of a single
+ * cpu:
+ *
+ *   cpu (2 bytes), length of records (4 bytes), records
+ *
+ * A record is a flags byte, followed by these fields:
+ *
+ *   cycle delta (varint)              unless TRACE_CYCLE_NEXT is set
+ *   pc delta (zigzag varint)          unless TRACE_PC_SEQ is set
+ *   instruction word (4 bytes)
+ *   ASID (1 byte)                     if TRACE_ASID is set
+ *   exception code (1 byte)           if TRACE_EXC is set
+ *
+ * Deltas, as well as the ASID (when absent), are relative to the
+ * previous record of the same cpu; the first record of each cpu is
+ * relative to cycle 0, pc 0 and ASID 0. TRACE_CYCLE_NEXT and
+ * TRACE_PC_SEQ stand for a delta of 1 and of one word, respectively.
+ */
+
+#ifndef UMPS_TRACE_FORMAT_H
+#define UMPS_TRACE_FORMAT_H
+
+#include "base/basic_types.h"
+
+#define TRACE_MAGIC "UMPT"
+#define TRACE_VERSION 1
+
+#define TRACE_HEADER_SIZE 8
+#define TRACE_CHUNK_HEADER_SIZE 6
+
+// Record flags
+#define TRACE_PC_SEQ        0x01
+#define TRACE_CYCLE_NEXT    0x02
+#define TRACE_ASID          0x04
+#define TRACE_EXC           0x08
+#define TRACE_USER          0x10
+
+// Upper bound on the encoded size of a record
+#define TRACE_MAX_RECORD    (1 + 10 + 5 + 4 + 1 + 1)
+
+inline unsigned int TracePutVarint(uint8_t* p, uint64_t value)
+{
+	unsigned int n = 0;
+	while (value >= 0x80) {
+		p[n++] = (uint8_t) value | 0x80;
+		value >>= 7;
+	}
+	p[n++] = (uint8_t) value;
+	return n;
+}
+
+// Returns the number of bytes decoded, or 0 if the varint does not
+// end within len bytes
+inline unsigned int TraceGetVarint(const uint8_t* p, unsigned int len, uint64_t* value)
+{
+	uint64_t v = 0;
+	for (unsigned int n = 0; n < len && n < 10; n++) {
+		v |= (uint64_t) (p[n] & 0x7f) << (7 * n);
+		if (!(p[n] & 0x80)) {
+			*value = v;
+			return n + 1;
+		}
+	}
+	return 0;
+}
+
+inline uint32_t TraceZigZag(int32_t value)
+{
+	return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+
+inline int32_t TraceUnZigZag(uint32_t value)
+{
+	return (int32_t) (value >> 1) ^ -(int32_t) (value & 1);
+}
+
+inline void TracePutLE(uint8_t* p, uint32_t value, unsigned int size)
+{
+	for (unsigned int i = 0; i < size; i++)
+		p[i] = (uint8_t) (value >> (8 * i));
+}
+
+inline uint32_t TraceGetLE(const uint8_t* p, unsigned int size)
+{
+	uint32_t value = 0;
+	for (unsigned int i = 0; i < size; i++)
+		value |= (uint32_t) p[i] << (8 * i);
+	return value;
+}
+
+#endif // UMPS_TRACE_FORMAT_H
@@ -0,0 +1,222 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "umps/trace_recorder.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "umps/error.h"
+#include "umps/trace_format.h"
+
+TraceRecorder::CpuStream::CpuStream()
+	: ring(new uint8_t[kRingSize]),
+	  head(0),
+	  tail(0),
+	  lastCycle(0),
+	  lastPC(0),
+	  lastASID(0)
+{
+}
+
+TraceRecorder::TraceRecorder(const MachineConfig* config)
+	: numCpus(config->getNumProcessors()),
+	  filterASID(config->getTraceASID()),
+	  filterStart(config->getTraceStart()),
+	  filterEnd(config->getTraceEnd()),
+	  filterMode(config->getTraceMode()),
+	  fileName(config->getTraceFile()),
+	  writeFailed(false),
+	  streams(new CpuStream[config->getNumProcessors()]),
+	  stopping(false)
+{
+	file = fopen(fileName.c_str(), "w");
+	if (file == NULL)
+		throw FileError(fileName);
+
+	uint8_t header[TRACE_HEADER_SIZE];
+	memcpy(header, TRACE_MAGIC, 4);
+	TracePutLE(header + 4, TRACE_VERSION, 2);
+	TracePutLE(header + 6, numCpus, 2);
+	if (fwrite(header, TRACE_HEADER_SIZE, 1, file) != 1) {
+		fclose(file);
+		throw FileError(fileName);
+	}
+
+	writer = std::thread(&TraceRecorder::writerLoop, this);
+}
+
+TraceRecorder::~TraceRecorder()
+{
+	{
+		std::lock_guard<std::mutex> lock(writerMutex);
+		stopping = true;
+	}
+	writerWakeup.notify_one();
+	writer.join();
+
+	fclose(file);
+}
+
+bool TraceRecorder::accept(Word pc, Word asid, bool user) const
+{
+	if (filterASID != MachineConfig::MAX_ASID && asid != filterASID)
+		return false;
+	if (pc < filterStart || pc > filterEnd)
+		return false;
+	if (filterMode == TRACE_MODE_KERNEL)
+		return !user;
+	if (filterMode == TRACE_MODE_USER)
+		return user;
+	return true;
+}
+
+void TraceRecorder::Record(Word cpu, uint64_t cycle, Word pc, Word instr,
+                           Word asid, bool user, int excCode)
+{
+	if (!accept(pc, asid, user))
+		return;
+
+	CpuStream& s = streams[cpu];
+	uint8_t rec[TRACE_MAX_RECORD];
+	uint8_t flags = 0;
+	size_t len = 1;
+
+	if (cycle == s.lastCycle + 1)
+		flags |= TRACE_CYCLE_NEXT;
+	else
+		len += TracePutVarint(rec + len, cycle - s.lastCycle);
+
+	if (pc == s.lastPC + WS)
+		flags |= TRACE_PC_SEQ;
+	else
+		len += TracePutVarint(rec + len, TraceZigZag((int32_t) (pc - s.lastPC)));
+
+	TracePutLE(rec + len, instr, 4);
+	len += 4;
+
+	if (asid != s.lastASID) {
+		flags |= TRACE_ASID;
+		rec[len++] = (uint8_t) asid;
+	}
+	if (excCode >= 0) {
+		flags |= TRACE_EXC;
+		rec[len++] = (uint8_t) excCode;
+	}
+	if (user)
+		flags |= TRACE_USER;
+	rec[0] = flags;
+
+	s.lastCycle = cycle;
+	s.lastPC = pc;
+	s.lastASID = asid;
+
+	put(cpu, rec, len);
+}
+
+void TraceRecorder::put(Word cpu, const uint8_t* rec, size_t len)
+{
+	CpuStream& s = streams[cpu];
+	size_t head = s.head.load(std::memory_order_relaxed);
+	size_t used = head - s.tail.load(std::memory_order_acquire);
+
+	// Ring full: the writer is behind, and we have to wait for it
+	while (kRingSize - used < len) {
+		writerWakeup.notify_one();
+		std::this_thread::yield();
+		used = head - s.tail.load(std::memory_order_acquire);
+	}
+
+	size_t ofs = head % kRingSize;
+	size_t n = std::min(len, kRingSize - ofs);
+	memcpy(&s.ring[ofs], rec, n);
+	memcpy(&s.ring[0], rec + n, len - n);
+	s.head.store(head + len, std::memory_order_release);
+
+	// Kick the writer as the ring gets half full
+	if (used < kRingSize / 2 && used + len >= kRingSize / 2)
+		writerWakeup.notify_one();
+}
+
+// Write out what all rings hold; returns true if anything was written
+bool TraceRecorder::drain(bool flush)
+{
+	bool written = false;
+
+	for (unsigned int cpu = 0; cpu < numCpus; cpu++) {
+		CpuStream& s = streams[cpu];
+		size_t tail = s.tail.load(std::memory_order_relaxed);
+		size_t head = s.head.load(std::memory_order_acquire);
+		if (head == tail)
+			continue;
+
+		if (!writeFailed) {
+			uint8_t chunkHeader[TRACE_CHUNK_HEADER_SIZE];
+			TracePutLE(chunkHeader, cpu, 2);
+			TracePutLE(chunkHeader + 2, head - tail, 4);
+
+			size_t ofs = tail % kRingSize;
+			size_t n = std::min(head - tail, kRingSize - ofs);
+			if (fwrite(chunkHeader, TRACE_CHUNK_HEADER_SIZE, 1, file) != 1 ||
+			    fwrite(&s.ring[ofs], 1, n, file) != n ||
+			    fwrite(&s.ring[0], 1, (head - tail) - n, file) != (head - tail) - n)
+				writeError();
+			else
+				written = true;
+		}
+
+		s.tail.store(head, std::memory_order_release);
+	}
+
+	if (flush && !writeFailed && fflush(file) == EOF)
+		writeError();
+	return written;
+}
+
+void TraceRecorder::writeError()
+{
+	writeFailed = true;
+	fprintf(stderr, "Error writing trace file `%s': %s; tracing stopped\n",
+	        fileName.c_str(), strerror(errno));
+}
+
+void TraceRecorder::writerLoop()
+{
+	std::unique_lock<std::mutex> lock(writerMutex);
+
+	while (!stopping) {
+		lock.unlock();
+		bool written = drain(false);
+		lock.lock();
+
+		// Nothing new: make the file current, then sleep until some
+		// ring fills up (or for a while)
+		if (!written && !stopping) {
+			if (!writeFailed && fflush(file) == EOF)
+				writeError();
+			writerWakeup.wait_for(lock, std::chrono::milliseconds(50));
+		}
+	}
+
+	drain(true);
+}
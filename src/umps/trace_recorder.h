@@ -0,0 +1,101 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef UMPS_TRACE_RECORDER_H
+#define UMPS_TRACE_RECORDER_H
+
+#include <stdio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "base/lang.h"
+#include "umps/machine_config.h"
+
+/*
+ * TraceRecorder writes a binary trace of the instructions executed by
+ * all cpus of a machine (see trace_format.h), as configured in
+ * MachineConfig.
+ *
+ * Records are encoded by the simulation thread into a per-cpu ring
+ * buffer, which a background thread drains to the trace file; the
+ * simulation only waits for the writer when a ring fills up.
+ */
+class TraceRecorder {
+public:
+	TraceRecorder(const MachineConfig* config);
+	~TraceRecorder();
+
+	// Record an instruction executed by cpu at the given cycle;
+	// excCode is the code of the exception taken, or -1 if none
+	void Record(Word cpu, uint64_t cycle, Word pc, Word instr,
+	            Word asid, bool user, int excCode);
+
+private:
+	static const size_t kRingSize = 256 * 1024;
+
+	struct CpuStream {
+		CpuStream();
+
+		scoped_array<uint8_t> ring;
+		std::atomic<size_t> head;
+		std::atomic<size_t> tail;
+
+		// Encoder state: the last record written
+		uint64_t lastCycle;
+		Word lastPC;
+		Word lastASID;
+	};
+
+	bool accept(Word pc, Word asid, bool user) const;
+	void put(Word cpu, const uint8_t* rec, size_t len);
+	bool drain(bool flush);
+	void writeError();
+	void writerLoop();
+
+	const unsigned int numCpus;
+
+	// Filters
+	const Word filterASID;
+	const Word filterStart;
+	const Word filterEnd;
+	const TraceMode filterMode;
+
+	std::string fileName;
+	FILE* file;
+
+	// Set once writing the file fails: the rest of the trace is
+	// discarded, so that the simulation never waits for the writer
+	bool writeFailed;
+
+	scoped_array<CpuStream> streams;
+
+	std::mutex writerMutex;
+	std::condition_variable writerWakeup;
+	bool stopping;
+	std::thread writer;
+
+	DISABLE_COPY_AND_ASSIGNMENT(TraceRecorder);
+};
+
+#endif // UMPS_TRACE_RECORDER_H
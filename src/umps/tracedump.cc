@@ -0,0 +1,244 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/****************************************************************************
+ *
+ * This is a stand-alone program which decodes instruction trace files
+ * recorded by the simulator (see trace_format.h) and prints them on the
+ * standard output, one executed instruction per line, with the code
+ * disassembled and (optionally) addresses mapped to symbol names.
+ *
+ * Records are printed in file order: records of each cpu come in
+ * chunks, so lines of different cpus are grouped, not sorted by cycle.
+ *
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <vector>
+
+#include <umps/const.h>
+#include "umps/types.h"
+#include "umps/disassemble.h"
+#include "umps/symbol_table.h"
+#include "umps/error.h"
+#include "umps/trace_format.h"
+
+// CAUSE register exception code names
+HIDDEN const char* const excCodeName[] = {
+	"Int", "Mod", "TLBL", "TLBS", "AdEL", "AdES", "IBE", "DBE",
+	"Sys", "Bp", "RI", "CpU", "Ov"
+};
+
+// per-cpu decoder state
+struct CpuState {
+	uint64_t cycle;
+	Word pc;
+	Word asid;
+};
+
+HIDDEN void showHelp(const char * prgName);
+HIDDEN int traceDump(const char * prgName, const char * fileName, SymbolTable * stab, long cpuFilter);
+HIDDEN bool decodeChunk(const uint8_t * buf, size_t len, unsigned int cpu, CpuState * st,
+                        SymbolTable * stab, bool show);
+
+// This function scans the line arguments; if no error is found, the
+// trace file is decoded, or a warning/help message is printed.
+// Returns an EXIT_SUCCESS/FAILURE code
+int main(int argc, char * argv[])
+{
+	const char * stabName = NULL;
+	Word stabASID = MAXASID;
+	long cpuFilter = -1;
+	SymbolTable * stab = NULL;
+	int ret = EXIT_SUCCESS;
+	int i;
+
+	if (argc == 1) {
+		showHelp(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// scan line arguments
+	for (i = 1; i < argc - 1 && ret != EXIT_FAILURE; i++)
+	{
+		if (SAMESTRING("-s", argv[i]) && i < argc - 2)
+			stabName = argv[++i];
+		else
+		if (SAMESTRING("-a", argv[i]) && i < argc - 2)
+			stabASID = strtoul(argv[++i], NULL, 0);
+		else
+		if (SAMESTRING("-c", argv[i]) && i < argc - 2)
+			cpuFilter = strtol(argv[++i], NULL, 0);
+		else
+			// unrecognized option
+			ret = EXIT_FAILURE;
+	}
+
+	if (ret == EXIT_FAILURE) {
+		showHelp(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (stabName != NULL) {
+		try {
+			stab = new SymbolTable(stabASID, stabName);
+		} catch (const Error& e) {
+			fprintf(stderr, "%s : %s\n", argv[0], e.what());
+			return EXIT_FAILURE;
+		}
+	}
+
+	ret = traceDump(argv[0], argv[argc - 1], stab, cpuFilter);
+	delete stab;
+	return ret;
+}
+
+// This function prints a warning/help message on standard error
+HIDDEN void showHelp(const char * prgName)
+{
+	fprintf(stderr, "%s syntax : %s [-s <stabfile>%s] [-a <asid>] [-c <cpu>] <tracefile>\n\n", prgName, prgName, MPSFILETYPE);
+	fprintf(stderr, "where:\n\n-s\tmap addresses to symbols found in <stabfile>%s\n", MPSFILETYPE);
+	fprintf(stderr, "-a\tASID the symbol table refers to (default: any, for kernel code)\n");
+	fprintf(stderr, "-c\tshow only instructions executed by <cpu>\n\n");
+}
+
+// This function reads the trace file header and all chunks, decoding
+// them. Returns an EXIT_SUCCESS/FAILURE code
+HIDDEN int traceDump(const char * prgName, const char * fileName, SymbolTable * stab, long cpuFilter)
+{
+	FILE * inF;
+	uint8_t header[TRACE_HEADER_SIZE];
+
+	if ((inF = fopen(fileName, "r")) == NULL) {
+		fprintf(stderr, "%s : Error opening file %s : %s\n", prgName, fileName, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	if (fread(header, TRACE_HEADER_SIZE, 1, inF) != 1 ||
+	    memcmp(header, TRACE_MAGIC, 4) != 0 ||
+	    TraceGetLE(header + 4, 2) != TRACE_VERSION) {
+		fprintf(stderr, "%s : Error : %s is not a trace file\n", prgName, fileName);
+		fclose(inF);
+		return EXIT_FAILURE;
+	}
+
+	unsigned int numCpus = TraceGetLE(header + 6, 2);
+	std::vector<CpuState> state(numCpus, CpuState{0, 0, 0});
+	std::vector<uint8_t> buf;
+	uint8_t chunkHeader[TRACE_CHUNK_HEADER_SIZE];
+	int ret = EXIT_SUCCESS;
+
+	while (fread(chunkHeader, TRACE_CHUNK_HEADER_SIZE, 1, inF) == 1) {
+		unsigned int cpu = TraceGetLE(chunkHeader, 2);
+		size_t len = TraceGetLE(chunkHeader + 2, 4);
+
+		buf.resize(len);
+		if (cpu >= numCpus || fread(buf.data(), 1, len, inF) != len ||
+		    !decodeChunk(buf.data(), len, cpu, &state[cpu], stab, cpuFilter < 0 || cpuFilter == (long) cpu)) {
+			fprintf(stderr, "%s : Error : %s is truncated or corrupted\n", prgName, fileName);
+			ret = EXIT_FAILURE;
+			break;
+		}
+	}
+
+	fclose(inF);
+	return ret;
+}
+
+// This function decodes a chunk of records of a cpu, printing them if
+// show is set (records of other cpus are decoded anyway, to keep their
+// state current). Returns FALSE if the chunk is malformed
+HIDDEN bool decodeChunk(const uint8_t * buf, size_t len, unsigned int cpu, CpuState * st,
+                        SymbolTable * stab, bool show)
+{
+	size_t i = 0;
+	uint64_t value;
+	unsigned int n;
+
+	while (i < len) {
+		uint8_t flags = buf[i++];
+
+		if (flags & TRACE_CYCLE_NEXT) {
+			st->cycle++;
+		} else {
+			if ((n = TraceGetVarint(buf + i, len - i, &value)) == 0)
+				return false;
+			st->cycle += value;
+			i += n;
+		}
+
+		if (flags & TRACE_PC_SEQ) {
+			st->pc += WORDLEN;
+		} else {
+			if ((n = TraceGetVarint(buf + i, len - i, &value)) == 0)
+				return false;
+			st->pc += TraceUnZigZag((uint32_t) value);
+			i += n;
+		}
+
+		if (len - i < 4)
+			return false;
+		Word instr = TraceGetLE(buf + i, 4);
+		i += 4;
+
+		if (flags & TRACE_ASID) {
+			if (i >= len)
+				return false;
+			st->asid = buf[i++];
+		}
+
+		int exc = -1;
+		if (flags & TRACE_EXC) {
+			if (i >= len)
+				return false;
+			exc = buf[i++];
+		}
+
+		if (!show)
+			continue;
+
+		printf("%2u %12llu %c %2u 0x%.8X ", cpu, (unsigned long long) st->cycle,
+		       (flags & TRACE_USER) ? 'U' : 'K', st->asid, st->pc);
+
+		const char * sym = NULL;
+		SWord offset = 0;
+		if (stab != NULL)
+			sym = stab->Probe(stab->getASID() == MAXASID ? MAXASID : st->asid, st->pc, false, &offset);
+		if (sym != NULL) {
+			char symStr[64];
+			snprintf(symStr, sizeof(symStr), "%s+0x%X", sym, (unsigned int) offset);
+			printf("%-24s ", symStr);
+		}
+
+		printf("%.8X  %s", instr, StrInstr(instr));
+		if (exc >= 0) {
+			if ((unsigned int) exc < sizeof(excCodeName) / sizeof(excCodeName[0]))
+				printf("  [%s]", excCodeName[exc]);
+			else
+				printf("  [exc %d]", exc);
+		}
+		printf("\n");
+	}
+	return true;
+}
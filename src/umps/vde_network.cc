@@ -42,6 +42,7 @@
 
 #include "umps/utility.h"
 #include "umps/error.h"
+#include "umps/vswitch.h"
 
 
 enum request_type { REQ_NEW_CONTROL };
@@ -58,38 +59,34 @@ struct request_v3 {
 #define STRBUFLEN 128
 #define MAXNETQUEUE 16
 #define MAXPACKETLEN 1536
+/* max frames received per polling() call */
+#define MAXNETBATCH (2 * MAXNETQUEUE)
 
 HIDDEN struct vdepluglib vdepluglib;
 HIDDEN char strbuf[STRBUFLEN];
-HIDDEN char packbuf[MAXPACKETLEN];
+/* frames which do not fit in the queue are received here and dropped */
+HIDDEN char dropbuf[MAXPACKETLEN];
 
 
-class netblock {
+/* Fixed ring of MTU-sized frame slots: frames are received straight into
+   the free slot at the tail and handed out in place from the head, so no
+   allocation or copy takes place on the receive path */
+class netring {
 public:
-netblock(const char *icontent,int ilen);
-~netblock(void);
-class netblock *getNext();
-void setNext(class netblock *p);
-char * getContent();
-int getLen();
-
-private:
-char *content;
-int len;
-struct netblock *next;
-};
-
-class netblockq {
-public:
-netblockq(int imaxelem);
-~netblockq();
-int enqueue(const char *content,int len);
+netring();
 int empty();
-int dequeue(char *pcontent, int len);
+int full();
+char *tailslot();
+void commit(int len);
+const Word *head(unsigned int *len);
+void drop();
 
 private:
-class netblock *head,*tail;
-int maxelem,nelem;
+struct netslot {
+	Word content[MAXPACKETLEN / WORDLEN];
+	int len;
+} slot[MAXNETQUEUE];
+int first,nelem;
 };
 
 unsigned int testnetinterface(const char *name)
@@ -97,6 +94,10 @@ unsigned int testnetinterface(const char *name)
 	char name2[1024];
 	int size;
 
+	/* in-process switches need no vde lib */
+	if (VirtualSwitch::IsSwitchName(name))
+		return 1;
+
 	if (!vdepluglib.dl_handle)
 		libvdeplug_dynopen(vdepluglib);
 	/* vde lib does not exist */
@@ -113,19 +114,31 @@ unsigned int testnetinterface(const char *name)
 	return 1;
 }
 
-netinterface::netinterface(const char *name, const char *addr, int intnum)
+netinterface::netinterface(const char *name, const char *addr, int intnum,
+                           unsigned int latency, unsigned int bandwidth)
 {
 	char name2[1024];
 	int size;
 
-	if ((size=readlink(name,name2,1023)) > 0) {
-		name2[size]=0;
-		name=name2;
-	}
-
-	vdeconn = vdepluglib.vde_open(name, (char*) "uMPS", NULL);
+	vdeconn=NULL;
+	swport=NULL;
 	queue=NULL;
-	polldata.fd = vdepluglib.vde_datafd(vdeconn);
+	if (VirtualSwitch::IsSwitchName(name)) {
+		/* latency and bandwidth are only simulated on virtual switches */
+		if ((swport=VirtualSwitch::Attach(name,latency,bandwidth)) == NULL) {
+			sprintf(strbuf,"%s: no free ports",name);
+			Panic(strbuf);
+		}
+		polldata.fd = -1;
+	} else {
+		if ((size=readlink(name,name2,1023)) > 0) {
+			name2[size]=0;
+			name=name2;
+		}
+
+		vdeconn = vdepluglib.vde_open(name, (char*) "uMPS", NULL);
+		polldata.fd = vdepluglib.vde_datafd(vdeconn);
+	}
 	polldata.events = POLLIN | POLLOUT | POLLERR | POLLHUP | POLLNVAL;
 
 	if (addr != NULL) {
@@ -138,29 +151,47 @@ netinterface::netinterface(const char *name, const char *addr, int intnum)
 		ethaddr[0]=intnum*2;
 		for (int i=1; i<6; i++)
 			ethaddr[i]=tempaddr[i];
+		/* all the machines on a virtual switch share the pid: tell
+		   them apart by switch port instead */
+		if (swport != NULL)
+			ethaddr[5]=swport->Number();
 	}
 
 	mode = PROMISQ | NAMED;
-	queue = new netblockq(MAXNETQUEUE);
+	queue = new netring();
 }
 
 netinterface::~netinterface(void)
 {
-	vdepluglib.vde_close(vdeconn);
+	if (swport != NULL)
+		swport->Detach();
+	else
+		vdepluglib.vde_close(vdeconn);
 	if (queue != NULL) delete queue;
 }
 
-unsigned int netinterface::readdata(char *buf, int len)
+const Word *netinterface::peekdata(unsigned int *len)
 {
 	if (queue->empty() && !this->polling())
-		return 0;
+		return NULL;
 	else
-		return queue->dequeue(buf, len);
+		return queue->head(len);
+}
+
+void netinterface::dropdata()
+{
+	queue->drop();
 }
 
 unsigned int netinterface::writedata(char *buf, int len)
 {
 	int retval,pollout;
+	if (swport != NULL) {
+		if (len >= 12 && (mode & NAMED) != 0)
+			memcpy(buf+6,ethaddr,6);
+		swport->Send(buf,len);
+		return len;
+	}
 	if ((pollout=poll(&polldata,1,0)) < 0) {
 		sprintf(strbuf,"poll: %s",strerror(errno));
 		Panic(strbuf);
@@ -180,28 +211,51 @@ unsigned int netinterface::writedata(char *buf, int len)
 
 unsigned int netinterface::polling()
 {
-	int len;
-	//socklen_t datainsize;
-	//struct sockaddr_un datain;
-	do {
-		if ((poll(&polldata,1,0)) < 0) {
-			sprintf(strbuf,"poll: %s",strerror(errno));
-			Panic(strbuf);
-		} else
-		if (polldata.revents & POLLIN) {
+	int len,n;
+	char *buf;
+
+	if (swport != NULL) {
+		/* frames are due at host time: take those which have come */
+		n=0;
+		do {
+			buf=queue->full() ? dropbuf : queue->tailslot();
+			len=swport->Receive(buf,MAXPACKETLEN);
+			if (len > 0 && buf != dropbuf && accept(buf,len))
+				queue->commit(len);
+		}
+		while (len > 0 && ++n < MAXNETBATCH);
+		return (!queue->empty());
+	}
+
+	if ((poll(&polldata,1,0)) < 0) {
+		sprintf(strbuf,"poll: %s",strerror(errno));
+		Panic(strbuf);
+	} else
+	if (polldata.revents & POLLIN) {
+		/* Drain a batch of frames with no further poll: each one is
+		   received straight into the free queue slot (or dropped, if
+		   the queue is full) */
+		n=0;
+		do {
+			buf=queue->full() ? dropbuf : queue->tailslot();
 			/* We don't store sender address to avoid EINVAL in recvfrom */
-			len=vdepluglib.vde_recv(vdeconn,packbuf,MAXPACKETLEN,0);
-			if (mode & PROMISQ                         //promiquous mode: receive everything
-			    || (len > 12                         // header okay and
-			        && (memcmp(packbuf,ethaddr,6)==0                         //it is sent to this interface
-			            || (packbuf[0] & 1))))                         //or it's a broadcast
-				queue->enqueue(packbuf,len);
+			len=vdepluglib.vde_recv(vdeconn,buf,MAXPACKETLEN,MSG_DONTWAIT);
+			if (len > 0 && buf != dropbuf && accept(buf,len))
+				queue->commit(len);
 		}
+		while (len > 0 && ++n < MAXNETBATCH);
 	}
-	while (polldata.revents & POLLIN);
 	return (!queue->empty());
 }
 
+int netinterface::accept(const char *buf, int len)
+{
+	return (mode & PROMISQ                         //promiquous mode: receive everything
+	        || (len > 12                         // header okay and
+	            && (memcmp(buf,ethaddr,6)==0                         //it is sent to this interface
+	                || (buf[0] & 1))));                         //or it's a broadcast
+}
+
 void netinterface::setaddr(char *iethaddr)
 {
 	register int i;
@@ -232,99 +286,48 @@ unsigned int netinterface::getmode()
 	return mode;
 }
 
-netblock::netblock(const char *icontent,int ilen)
+netring::netring()
 {
-	if (ilen>0) {
-		content=new char [ilen];
-		memcpy(content,icontent,ilen);
-	} else
-		content=NULL;
-	len=ilen;
+	first=nelem=0;
 }
 
-netblock::~netblock(void)
+int netring::empty()
 {
-	if (content != NULL)
-		delete(content);
+	return nelem==0;
 }
 
-class netblock *netblock::getNext()
+int netring::full()
 {
-	return next;
+	return nelem==MAXNETQUEUE;
 }
 
-void netblock::setNext(class netblock *p)
+char *netring::tailslot()
 {
-	next=p;
+	return (char *) slot[(first+nelem) % MAXNETQUEUE].content;
 }
 
-char *netblock::getContent()
+void netring::commit(int len)
 {
-	return content;
+	slot[(first+nelem) % MAXNETQUEUE].len=len;
+	nelem++;
 }
 
-int netblock::getLen()
+const Word *netring::head(unsigned int *len)
 {
-	return len;
-}
-
-
-netblockq::netblockq(int imaxelem)
-{
-	maxelem=imaxelem;
-	head=tail=NULL;
-	nelem=0;
-}
-
-netblockq::~netblockq()
-{
-	class netblock *next;
-	while (head != NULL)
-	{
-		next=head->getNext();
-		delete (head);
-		head=next;
-	}
-}
-
-int netblockq::enqueue(const char *content,int len)
-{
-	if (nelem >= maxelem)
-		return 0;
+	if (nelem==0)
+		return NULL;
 	else
 	{
-		class netblock *oldtail=tail;
-		tail=new netblock(content,len);
-		if (oldtail!=NULL)
-			oldtail->setNext(tail);
-		tail->setNext(NULL);
-		if (head==NULL)
-			head=tail;
-		nelem++;
-		return 1;
+		*len=slot[first].len;
+		return slot[first].content;
 	}
 }
 
-int netblockq::empty()
-{
-	return head==NULL;
-}
-
-int netblockq::dequeue(char *pcontent, int len)
+void netring::drop()
 {
-	if (head==NULL)
-		return 0;
-	else
+	if (nelem > 0)
 	{
-		class netblock *oldhead=head;
-		int packlen;
-		head=oldhead->getNext();
-		if (head == NULL) tail = NULL;
-		packlen=oldhead->getLen();
-		if (len < packlen) packlen=len;
-		memcpy(pcontent,oldhead->getContent(),packlen);
-		delete oldhead;
+		first=(first+1) % MAXNETQUEUE;
 		nelem--;
-		return packlen;
 	}
 }
@@ -25,9 +25,11 @@
 #include <sys/poll.h>
 #include <sys/un.h>
 
+#include "umps/types.h"
 #include "umps/libvdeplug_dyn.h"
 
-class netblockq;
+class netring;
+class VirtualSwitchPort;
 
 #define PROMISQ  0x4
 #define INTERRUPT  0x2
@@ -38,11 +40,13 @@ unsigned int testnetinterface(const char *name);
 class netinterface
 {
 public:
-netinterface(const char *name, const char *addr, int intnum);
+netinterface(const char *name, const char *addr, int intnum,
+             unsigned int latency = 0, unsigned int bandwidth = 0);
 
 ~netinterface(void);
 
-unsigned int readdata(char *buf, int len);
+const Word *peekdata(unsigned int *len);
+void dropdata();
 unsigned int writedata(char *buf, int len);
 unsigned int polling();
 void setaddr(char *iethaddr);
@@ -51,11 +55,14 @@ void setmode(int imode);
 unsigned int getmode();
 
 private:
+int accept(const char *buf, int len);
+
 VDECONN *vdeconn;
+VirtualSwitchPort *swport;
 char ethaddr[6];
 char mode;
 struct pollfd polldata;
-class netblockq *queue;
+class netring *queue;
 };
 
 #endif // UMPS_VDE_NETWORK_H
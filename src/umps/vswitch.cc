@@ -0,0 +1,220 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "umps/vswitch.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+const char* const VirtualSwitch::kNamePrefix = "vswitch:";
+
+// Switches share no simulated clock: frame timing is kept in host
+// microseconds
+static uint64_t HostMicros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t FrameMAC(const char* p)
+{
+	uint64_t mac = 0;
+	for (unsigned int i = 0; i < 6; i++)
+		mac = (mac << 8) | (uint8_t) p[i];
+	return mac;
+}
+
+
+VirtualSwitchPort::VirtualSwitchPort()
+	: sw(NULL),
+	  id(0),
+	  latency(0),
+	  bandwidth(0),
+	  txBusyUntil(0),
+	  attached(false),
+	  enqPos(0),
+	  deqPos(0)
+{
+	for (unsigned int i = 0; i < kQueueSize; i++)
+		inbox[i].seq.store(i, std::memory_order_relaxed);
+}
+
+void VirtualSwitchPort::Setup(VirtualSwitch* s, unsigned int i, unsigned int lat, unsigned int bw)
+{
+	sw = s;
+	id = i;
+	latency = lat;
+	bandwidth = bw;
+	txBusyUntil = 0;
+
+	// Whatever was left for the previous owner is stale
+	for (;;) {
+		Slot* slot = &inbox[deqPos % kQueueSize];
+		if (slot->seq.load(std::memory_order_acquire) != deqPos + 1)
+			break;
+		slot->seq.store(deqPos + kQueueSize, std::memory_order_release);
+		deqPos++;
+	}
+
+	attached.store(true, std::memory_order_release);
+}
+
+void VirtualSwitchPort::Send(const char* frame, unsigned int len)
+{
+	if (len < 12 || len > kMaxFrameLen)
+		return;
+
+	// The frame is put on the wire once the previous ones are gone
+	// and is seen by the receiver a link latency after its last bit
+	uint64_t now = HostMicros();
+	uint64_t start = std::max(now, txBusyUntil);
+	if (bandwidth)
+		txBusyUntil = start + (uint64_t) len * 8 * 1000 / bandwidth;
+	else
+		txBusyUntil = start;
+
+	sw->Forward(this, frame, len, txBusyUntil + latency);
+}
+
+bool VirtualSwitchPort::Enqueue(const char* frame, unsigned int len, uint64_t due)
+{
+	size_t pos = enqPos.load(std::memory_order_relaxed);
+	Slot* slot;
+
+	for (;;) {
+		slot = &inbox[pos % kQueueSize];
+		size_t seq = slot->seq.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+		if (diff == 0) {
+			if (enqPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			// Inbox full
+			return false;
+		} else {
+			pos = enqPos.load(std::memory_order_relaxed);
+		}
+	}
+
+	memcpy(slot->frame, frame, len);
+	slot->len = len;
+	slot->due = due;
+	slot->seq.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+unsigned int VirtualSwitchPort::Receive(char* buf, unsigned int len)
+{
+	Slot* slot = &inbox[deqPos % kQueueSize];
+
+	if (slot->seq.load(std::memory_order_acquire) != deqPos + 1)
+		return 0;
+	if (slot->due > HostMicros())
+		return 0;
+
+	len = std::min(len, slot->len);
+	memcpy(buf, slot->frame, len);
+	slot->seq.store(deqPos + kQueueSize, std::memory_order_release);
+	deqPos++;
+	return len;
+}
+
+void VirtualSwitchPort::Detach()
+{
+	// Forget the addresses learnt on this port
+	uint64_t portTag = id + 1;
+	for (unsigned int i = 0; i < VirtualSwitch::kMacTableSize; i++) {
+		uint64_t entry = sw->macTable[i].load(std::memory_order_relaxed);
+		if ((entry & 0xff) == portTag)
+			sw->macTable[i].compare_exchange_strong(entry, 0, std::memory_order_relaxed);
+	}
+
+	attached.store(false, std::memory_order_release);
+}
+
+VirtualSwitch::VirtualSwitch()
+{
+	for (unsigned int i = 0; i < kMacTableSize; i++)
+		macTable[i].store(0, std::memory_order_relaxed);
+}
+
+// Hash a MAC address into the table: vendor and serial bytes both
+// count, so multiplicative (Fibonacci) hashing is used
+unsigned int VirtualSwitch::MACSlot(uint64_t mac)
+{
+	return (mac * 0x9E3779B97F4A7C15ULL) >> (64 - kMacTableBits);
+}
+
+bool VirtualSwitch::IsSwitchName(const char* name)
+{
+	return strncmp(name, kNamePrefix, strlen(kNamePrefix)) == 0;
+}
+
+VirtualSwitchPort* VirtualSwitch::Attach(const char* name, unsigned int latency, unsigned int bandwidth)
+{
+	static std::mutex registryMutex;
+	static std::map<std::string, VirtualSwitch*> registry;
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+
+	// Switches and their ports are never freed, so that a sender
+	// racing with a detach never touches released memory
+	VirtualSwitch*& sw = registry[name + strlen(kNamePrefix)];
+	if (sw == NULL)
+		sw = new VirtualSwitch;
+
+	for (unsigned int i = 0; i < kMaxPorts; i++) {
+		if (!sw->ports[i].attached.load(std::memory_order_acquire)) {
+			sw->ports[i].Setup(sw, i, latency, bandwidth);
+			return &sw->ports[i];
+		}
+	}
+	return NULL;
+}
+
+void VirtualSwitch::Forward(VirtualSwitchPort* from, const char* frame, unsigned int len, uint64_t due)
+{
+	// Learn the source address (unless it is a group address)
+	uint64_t src = FrameMAC(frame + 6);
+	if (!(frame[6] & 1))
+		macTable[MACSlot(src)].store((src << 8) | (from->id + 1), std::memory_order_relaxed);
+
+	uint64_t dst = FrameMAC(frame);
+	if (!(frame[0] & 1)) {
+		uint64_t entry = macTable[MACSlot(dst)].load(std::memory_order_relaxed);
+		if (entry != 0 && (entry >> 8) == dst) {
+			VirtualSwitchPort* to = &ports[(entry & 0xff) - 1];
+			if (to->attached.load(std::memory_order_acquire)) {
+				if (to != from)
+					to->Enqueue(frame, len, due);
+				return;
+			}
+		}
+	}
+
+	// Broadcast, multicast or unknown destination: flood
+	for (unsigned int i = 0; i < kMaxPorts; i++)
+		if (&ports[i] != from && ports[i].attached.load(std::memory_order_acquire))
+			ports[i].Enqueue(frame, len, due);
+}
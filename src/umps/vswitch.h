@@ -0,0 +1,130 @@
+/*
+ * uMPS - A general purpose computer system simulator
+ *
+ * Copyright (C) 2026 The uMPS Authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef UMPS_VSWITCH_H
+#define UMPS_VSWITCH_H
+
+#include <atomic>
+
+#include "base/basic_types.h"
+
+class VirtualSwitch;
+
+/*
+ * A port of an in-process virtual Ethernet switch (see VirtualSwitch).
+ *
+ * Frames sent through a port are forwarded to the inbox of other
+ * ports, each one a bounded lock-free queue: any number of threads may
+ * send, while a port is only ever received from by its owner. Every
+ * frame carries the (host clock) time it is due at the receiver, which
+ * accounts for link latency and bandwidth of the sending port.
+ */
+class VirtualSwitchPort {
+public:
+	static const unsigned int kMaxFrameLen = 1536;
+
+	// Send a frame; frames are silently dropped when the inbox of
+	// the receiver is full, as a real switch would do.
+	void Send(const char* frame, unsigned int len);
+
+	// Copy the next frame due into buf, if any, and return its
+	// length (0 if there is no frame yet).
+	unsigned int Receive(char* buf, unsigned int len);
+
+	// Leave the switch; the port must not be used afterwards.
+	void Detach();
+
+	// Number of the port, unique among those attached to the switch
+	unsigned int Number() const { return id; }
+
+private:
+	static const unsigned int kQueueSize = 64;
+
+	struct Slot {
+		std::atomic<size_t> seq;
+		uint64_t due;
+		unsigned int len;
+		char frame[kMaxFrameLen];
+	};
+
+	VirtualSwitchPort();
+
+	void Setup(VirtualSwitch* sw, unsigned int id, unsigned int latency, unsigned int bandwidth);
+	bool Enqueue(const char* frame, unsigned int len, uint64_t due);
+
+	VirtualSwitch* sw;
+	unsigned int id;
+
+	// Link parameters: latency in microseconds and bandwidth in
+	// kbit/s (0 for unlimited), and the time the link will be done
+	// transmitting what has been sent so far.
+	unsigned int latency;
+	unsigned int bandwidth;
+	uint64_t txBusyUntil;
+
+	std::atomic<bool> attached;
+
+	Slot inbox[kQueueSize];
+	std::atomic<size_t> enqPos;
+	size_t deqPos;
+
+	friend class VirtualSwitch;
+};
+
+/*
+ * VirtualSwitch is a learning Ethernet switch living in the simulator
+ * process: EthDevices of several Machine instances (possibly running in
+ * different threads) attach to it by configuring a device file named
+ * "vswitch:<name>", with no VDE daemon or socket involved.
+ *
+ * Switches are created on first use and live as long as the process.
+ */
+class VirtualSwitch {
+public:
+	static const char* const kNamePrefix;
+	static const unsigned int kMaxPorts = 32;
+
+	// Tell whether a device file name refers to a virtual switch
+	static bool IsSwitchName(const char* name);
+
+	// Attach a new port to the switch named by a "vswitch:<name>"
+	// device file name; returns NULL if all ports are taken.
+	static VirtualSwitchPort* Attach(const char* name, unsigned int latency, unsigned int bandwidth);
+
+private:
+	static const unsigned int kMacTableBits = 10;
+	static const unsigned int kMacTableSize = 1U << kMacTableBits;
+
+	VirtualSwitch();
+
+	static unsigned int MACSlot(uint64_t mac);
+
+	void Forward(VirtualSwitchPort* from, const char* frame, unsigned int len, uint64_t due);
+
+	VirtualSwitchPort ports[kMaxPorts];
+
+	// Learnt addresses, each entry packing a MAC address and the
+	// number of its port plus one (0 for empty entries)
+	std::atomic<uint64_t> macTable[kMacTableSize];
+
+	friend class VirtualSwitchPort;
+};
+
+#endif // UMPS_VSWITCH_H